@@ -2,23 +2,58 @@
 #include <js.h>
 #include <jstl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <string>
+
 #include "SDL3/SDL_camera.h"
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_audio.h>
 
 using bare_sdl_audio_stream_get_callback_t = js_function_t<void, int, int>;
 using bare_sdl_audio_stream_put_callback_t = js_function_t<void, int, int>;
+using bare_sdl_frame_scheduler_callback_t = js_function_t<void, double, uint32_t>;
+using bare_sdl_event_watch_callback_t = js_function_t<void>;
 
 typedef struct {
   SDL_Window *handle;
 } bare_sdl_window_t;
 
+#define BARE_SDL_RENDER_STATS_FRAMES 240
+
+enum {
+  bare_sdl_render_phase_upload,
+  bare_sdl_render_phase_clear,
+  bare_sdl_render_phase_draw,
+  bare_sdl_render_phase_present,
+  bare_sdl_render_phase_interval,
+  bare_sdl_render_phase_count,
+};
+
+typedef struct {
+  uint64_t phases[bare_sdl_render_phase_count];
+  uint64_t draw_calls;
+  uint64_t uploaded_bytes;
+} bare_sdl_render_frame_stats_t;
+
+typedef struct {
+  bool enabled;
+  uint32_t head;
+  uint32_t count;
+  uint64_t last_present;
+  bare_sdl_render_frame_stats_t current;
+  bare_sdl_render_frame_stats_t frames[BARE_SDL_RENDER_STATS_FRAMES];
+} bare_sdl_render_stats_t;
+
 typedef struct {
   SDL_Renderer *handle;
+  bare_sdl_render_stats_t stats;
 } bare_sdl_renderer_t;
 
 typedef struct {
   SDL_Texture *handle;
+  int pitch;
+  size_t locked_size;
 } bare_sdl_texture_t;
 
 typedef struct {
@@ -30,12 +65,108 @@ typedef struct {
 } bare_sdl_frect_t;
 
 typedef struct {
-  SDL_Event handle;
-} bare_sdl_event_t;
+  SDL_JoystickID id;
+  SDL_Joystick *handle;
+} bare_sdl_virtual_joystick_t;
+
+typedef struct {
+  uint64_t underruns;
+  uint64_t overruns;
+  uint64_t coalesced;
+  uint64_t deliveries;
+  uint64_t delay_last;
+  uint64_t delay_max;
+  uint64_t delay_total;
+} bare_sdl_audio_stream_stats_t;
+
+#define BARE_SDL_AUDIO_MIXER_SOURCES 32
+#define BARE_SDL_AUDIO_MIXER_SAMPLES 2048
+
+typedef struct {
+  SDL_AudioStream *stream;
+  float gain;
+  float pan;
+} bare_sdl_audio_mixer_source_t;
+
+typedef struct {
+  SDL_AudioStream *output;
+  int channels;
+  int freq;
+
+  bare_sdl_audio_mixer_source_t sources[BARE_SDL_AUDIO_MIXER_SOURCES];
+
+  // Mixing happens in chunks of at most BARE_SDL_AUDIO_MIXER_SAMPLES samples
+  // so the audio thread never allocates.
+  float mix[BARE_SDL_AUDIO_MIXER_SAMPLES];
+  float scratch[BARE_SDL_AUDIO_MIXER_SAMPLES];
+} bare_sdl_audio_mixer_t;
+
+#define BARE_SDL_AUDIO_FILE_CHUNK 4096
+#define BARE_SDL_AUDIO_FILE_RING  (1 << 19)
+
+typedef struct {
+  SDL_AudioStream *stream;
+  SDL_IOStream *io;
+  SDL_AudioSpec spec;
+  int frame_size;
+
+  // Byte range of the sample data within the file, and how much of it has
+  // been read into the ring. Guarded by the mutex.
+  Sint64 data_start;
+  Sint64 data_size;
+  Sint64 read;
+
+  bool loop;
+  bool eof;
+  bool stopping;
+
+  // Reader thread that keeps the ring filled so that the audio thread never
+  // touches the file. The ring holds a whole number of frames and is indexed
+  // by monotonic byte counters, the reader advancing the write counter and
+  // the audio thread the read counter.
+  uv_thread_t thread;
+  uv_mutex_t mutex;
+  uv_sem_t wake;
+
+  uint8_t *ring;
+  uint64_t ring_capacity;
+  uint64_t ring_read;
+  uint64_t ring_write;
+
+  // Playback position within the sample data of the next byte taken from the
+  // ring, and whether the end was reached. Guarded by the stream lock.
+  Sint64 position;
+  bool ended;
+} bare_sdl_audio_file_t;
+
+#define BARE_SDL_AUDIO_RECORDER_CHUNK 4096
 
 typedef struct {
-  SDL_KeyboardEvent handle;
-} bare_sdl_keyboard_event_t;
+  SDL_AudioStream *stream;
+  SDL_IOStream *io;
+  SDL_AudioSpec spec;
+  bool wav;
+
+  uv_thread_t thread;
+  uv_sem_t wake;
+
+  // Lock-free bounded queue between the audio thread and the writer thread,
+  // indexed by monotonic byte counters. The audio thread advances the write
+  // counter and the writer thread the read counter.
+  uint8_t *queue;
+  uint64_t capacity;
+  uint64_t read;
+  uint64_t write;
+
+  uint64_t written;
+  uint64_t dropped;
+
+  bool running;
+  bool failed;
+  bool stopped;
+
+  uint8_t chunk[BARE_SDL_AUDIO_RECORDER_CHUNK];
+} bare_sdl_audio_recorder_t;
 
 typedef struct bare_sdl_audio_stream_s {
   SDL_AudioStream *handle;
@@ -52,6 +183,18 @@ typedef struct bare_sdl_audio_stream_s {
   int put_added_bytes;
   int put_total_bytes;
   int pending_closes;
+
+  bool get_pending;
+  bool put_pending;
+  uint64_t get_since;
+  uint64_t put_since;
+
+  bare_sdl_audio_stream_stats_t stats;
+
+  uint8_t *ring;
+  uint32_t ring_capacity;
+  int ring_frame_size;
+  bool ring_recording;
 } bare_sdl_audio_stream_t;
 
 typedef struct {
@@ -79,13 +222,80 @@ typedef struct {
   uint64_t timestamp;
 } bare_sdl_camera_frame_t;
 
+typedef struct {
+  uv_timer_t *timer;
+  js_env_t *env;
+  js_persistent_t<bare_sdl_frame_scheduler_callback_t> on_frame;
+
+  uint64_t interval;
+  uint64_t start;
+  uint64_t frames;
+  uint64_t skipped;
+  uint64_t frame_time;
+  bool active;
+} bare_sdl_frame_scheduler_t;
+
+typedef struct {
+  uv_async_t *async;
+  uv_timer_t *pump;
+  js_env_t *env;
+  js_persistent_t<bare_sdl_event_watch_callback_t> on_events;
+
+  bool active;
+} bare_sdl_event_watch_t;
+
 static uv_once_t bare_sdl__init_guard = UV_ONCE_INIT;
 
 static void
 bare_sdl__on_init(void) {
   // Note: This is a way to prevent SDL to handle signals
   SDL_SetHint(SDL_HINT_NO_SIGNAL_HANDLERS, "1");
-  SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_CAMERA);
+  SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO | SDL_INIT_CAMERA | SDL_INIT_GAMEPAD);
+}
+
+// Render stats
+
+static inline uint64_t
+bare_sdl__render_stats_begin(bare_sdl_render_stats_t *stats) {
+  return stats->enabled ? SDL_GetPerformanceCounter() : 0;
+}
+
+static inline void
+bare_sdl__render_stats_end(bare_sdl_render_stats_t *stats, int phase, uint64_t start) {
+  if (stats->enabled) stats->current.phases[phase] += SDL_GetPerformanceCounter() - start;
+}
+
+static void
+bare_sdl__render_stats_upload(bare_sdl_render_stats_t *stats, uint64_t start, size_t bytes) {
+  if (!stats->enabled) return;
+
+  stats->current.phases[bare_sdl_render_phase_upload] += SDL_GetPerformanceCounter() - start;
+  stats->current.uploaded_bytes += bytes;
+}
+
+static inline void
+bare_sdl__render_stats_draw(bare_sdl_render_stats_t *stats) {
+  if (stats->enabled) stats->current.draw_calls++;
+}
+
+static void
+bare_sdl__render_stats_commit(bare_sdl_render_stats_t *stats) {
+  if (!stats->enabled) return;
+
+  uint64_t now = SDL_GetPerformanceCounter();
+
+  if (stats->last_present) {
+    stats->current.phases[bare_sdl_render_phase_interval] = now - stats->last_present;
+  }
+
+  stats->last_present = now;
+
+  stats->frames[stats->head] = stats->current;
+  stats->head = (stats->head + 1) % BARE_SDL_RENDER_STATS_FRAMES;
+
+  if (stats->count < BARE_SDL_RENDER_STATS_FRAMES) stats->count++;
+
+  stats->current = {};
 }
 
 // Window
@@ -134,7 +344,10 @@ static js_arraybuffer_t
 bare_sdl_create_renderer(
   js_env_t *env,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_window_t, 1> win
+  js_arraybuffer_span_of_t<bare_sdl_window_t, 1> win,
+  std::optional<std::string> driver,
+  std::optional<int> vsync,
+  std::optional<uint32_t> colorspace
 ) {
   int err;
 
@@ -144,7 +357,25 @@ bare_sdl_create_renderer(
   err = js_create_arraybuffer(env, ren, handle);
   assert(err == 0);
 
-  ren->handle = SDL_CreateRenderer(win->handle, nullptr);
+  SDL_PropertiesID props = SDL_CreateProperties();
+
+  SDL_SetPointerProperty(props, SDL_PROP_RENDERER_CREATE_WINDOW_POINTER, win->handle);
+
+  if (driver.has_value()) {
+    SDL_SetStringProperty(props, SDL_PROP_RENDERER_CREATE_NAME_STRING, driver->c_str());
+  }
+
+  if (vsync.has_value()) {
+    SDL_SetNumberProperty(props, SDL_PROP_RENDERER_CREATE_PRESENT_VSYNC_NUMBER, vsync.value());
+  }
+
+  if (colorspace.has_value()) {
+    SDL_SetNumberProperty(props, SDL_PROP_RENDERER_CREATE_OUTPUT_COLORSPACE_NUMBER, colorspace.value());
+  }
+
+  ren->handle = SDL_CreateRendererWithProperties(props);
+
+  SDL_DestroyProperties(props);
 
   if (ren->handle == nullptr) {
     err = js_throw_error(env, nullptr, SDL_GetError());
@@ -165,13 +396,105 @@ bare_sdl_destroy_renderer(
   SDL_DestroyRenderer(ren->handle);
 }
 
+static std::vector<std::string>
+bare_sdl_get_render_drivers(
+  js_env_t *,
+  js_receiver_t
+) {
+  std::vector<std::string> list;
+
+  int count = SDL_GetNumRenderDrivers();
+
+  for (int i = 0; i < count; i++) {
+    list.push_back(SDL_GetRenderDriver(i));
+  }
+
+  return list;
+}
+
+static std::string
+bare_sdl_get_renderer_name(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  const char *name = SDL_GetRendererName(ren->handle);
+  return name ? name : "";
+}
+
+static int64_t
+bare_sdl_get_renderer_max_texture_size(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  return SDL_GetNumberProperty(SDL_GetRendererProperties(ren->handle), SDL_PROP_RENDERER_MAX_TEXTURE_SIZE_NUMBER, 0);
+}
+
+static std::vector<uint32_t>
+bare_sdl_get_renderer_texture_formats(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  auto formats = static_cast<const SDL_PixelFormat *>(
+    SDL_GetPointerProperty(SDL_GetRendererProperties(ren->handle), SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr)
+  );
+
+  std::vector<uint32_t> list;
+
+  if (formats != nullptr) {
+    for (int i = 0; formats[i] != SDL_PIXELFORMAT_UNKNOWN; i++) {
+      list.push_back(formats[i]);
+    }
+  }
+
+  return list;
+}
+
+static int
+bare_sdl_get_render_vsync(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  int err;
+
+  int vsync;
+
+  if (!SDL_GetRenderVSync(ren->handle, &vsync)) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return vsync;
+}
+
+static bool
+bare_sdl_set_render_vsync(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  int vsync
+) {
+  return SDL_SetRenderVSync(ren->handle, vsync);
+}
+
 static bool
 bare_sdl_clear_render(
   js_env_t *env,
   js_receiver_t,
   js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
 ) {
-  return SDL_RenderClear(ren->handle);
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_RenderClear(ren->handle);
+
+  bare_sdl__render_stats_end(&ren->stats, bare_sdl_render_phase_clear, start);
+
+  return success;
 }
 
 static bool
@@ -180,7 +503,14 @@ bare_sdl_present_render(
   js_receiver_t,
   js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
 ) {
-  return SDL_RenderPresent(ren->handle);
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_RenderPresent(ren->handle);
+
+  bare_sdl__render_stats_end(&ren->stats, bare_sdl_render_phase_present, start);
+  bare_sdl__render_stats_commit(&ren->stats);
+
+  return success;
 }
 
 static bool
@@ -194,775 +524,4366 @@ bare_sdl_texture_render(
 ) {
   const SDL_FRect *src_r = src.has_value() ? &src.value()->handle : nullptr;
   const SDL_FRect *dst_r = dst.has_value() ? &dst.value()->handle : nullptr;
-  return SDL_RenderTexture(ren->handle, tex->handle, src_r, dst_r);
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_RenderTexture(ren->handle, tex->handle, src_r, dst_r);
+
+  bare_sdl__render_stats_end(&ren->stats, bare_sdl_render_phase_draw, start);
+
+  bare_sdl__render_stats_draw(&ren->stats);
+
+  return success;
 }
 
-// Texture
+static bool
+bare_sdl_set_render_target(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_texture_t, 1>> tex
+) {
+  return SDL_SetRenderTarget(ren->handle, tex.has_value() ? tex.value()->handle : nullptr);
+}
 
-static js_arraybuffer_t
-bare_sdl_create_texture(
+static bool
+bare_sdl_read_render_pixels(
   js_env_t *env,
   js_receiver_t,
   js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
-  uint64_t pixel_format,
-  uint64_t texture_access,
-  int width,
-  int height
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int pitch,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect,
+  std::optional<uint32_t> pixel_format
 ) {
   int err;
 
-  js_arraybuffer_t handle;
+  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
 
-  bare_sdl_texture_t *tex;
-  err = js_create_arraybuffer(env, tex, handle);
-  assert(err == 0);
+  SDL_Surface *surface = SDL_RenderReadPixels(ren->handle, r);
 
-  tex->handle = SDL_CreateTexture(
-    ren->handle,
-    static_cast<SDL_PixelFormat>(pixel_format),
-    static_cast<SDL_TextureAccess>(texture_access),
-    width,
-    height
-  );
+  if (surface == nullptr) return false;
 
-  if (tex->handle == nullptr) {
-    err = js_throw_error(env, nullptr, SDL_GetError());
+  auto format = pixel_format.has_value() ? static_cast<SDL_PixelFormat>(pixel_format.value()) : surface->format;
+
+  // Planar and packed YUV layouts are not described by a single pitch, so
+  // only packed RGB formats can be read back.
+  if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+    SDL_DestroySurface(surface);
+
+    err = js_throw_error(env, nullptr, "Pixel format not supported for readback");
     assert(err == 0);
 
     throw js_pending_exception;
   }
 
-  return handle;
+  if (pitch < surface->w * SDL_BYTESPERPIXEL(format)) {
+    SDL_DestroySurface(surface);
+
+    err = js_throw_range_error(env, nullptr, "Pitch too small for the read area");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (buf_offset + static_cast<size_t>(pitch) * static_cast<size_t>(surface->h) > buf.size()) {
+    SDL_DestroySurface(surface);
+
+    err = js_throw_range_error(env, nullptr, "Pixel buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  bool success = SDL_ConvertPixels(
+    surface->w,
+    surface->h,
+    surface->format,
+    surface->pixels,
+    surface->pitch,
+    format,
+    &buf[buf_offset],
+    pitch
+  );
+
+  SDL_DestroySurface(surface);
+
+  return success;
 }
 
 static void
-bare_sdl_destroy_texture(
+bare_sdl__check_vertex_bounds(
   js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex
+  const js_arraybuffer_span_t &buf,
+  uint32_t offset,
+  int stride,
+  int count,
+  size_t size,
+  const char *name
 ) {
-  SDL_DestroyTexture(tex->handle);
+  int err;
+
+  if (count == 0) return;
+
+  if (stride < 0 || offset + static_cast<size_t>(stride) * static_cast<size_t>(count - 1) + size > buf.size()) {
+    err = js_throw_range_errorf(env, nullptr, "%s buffer out of bounds", name);
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
 }
 
 static bool
-bare_sdl_update_texture(
+bare_sdl_render_geometry(
   js_env_t *env,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
-  js_arraybuffer_span_t buf,
-  uint32_t buf_offset,
-  int pitch,
-  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_texture_t, 1>> tex,
+  int num_vertices,
+  js_arraybuffer_span_t xy,
+  uint32_t xy_offset,
+  int xy_stride,
+  js_arraybuffer_span_t color,
+  uint32_t color_offset,
+  int color_stride,
+  std::optional<js_arraybuffer_span_t> uv,
+  uint32_t uv_offset,
+  int uv_stride,
+  std::optional<js_arraybuffer_span_t> indices,
+  uint32_t indices_offset,
+  int num_indices,
+  int size_indices
 ) {
-  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
-  return SDL_UpdateTexture(tex->handle, r, &buf[buf_offset], pitch);
+  int err;
+
+  bare_sdl__check_vertex_bounds(env, xy, xy_offset, xy_stride, num_vertices, 2 * sizeof(float), "Position");
+  bare_sdl__check_vertex_bounds(env, color, color_offset, color_stride, num_vertices, sizeof(SDL_FColor), "Color");
+
+  const float *uv_ptr = nullptr;
+
+  if (uv.has_value()) {
+    bare_sdl__check_vertex_bounds(env, uv.value(), uv_offset, uv_stride, num_vertices, 2 * sizeof(float), "Texture coordinate");
+
+    uv_ptr = reinterpret_cast<const float *>(&uv.value()[uv_offset]);
+  }
+
+  const void *indices_ptr = nullptr;
+
+  if (indices.has_value()) {
+    if (size_indices != 1 && size_indices != 2 && size_indices != 4) {
+      err = js_throw_range_error(env, nullptr, "Index size must be 1, 2, or 4 bytes");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+
+    bare_sdl__check_vertex_bounds(env, indices.value(), indices_offset, size_indices, num_indices, size_indices, "Index");
+
+    indices_ptr = &indices.value()[indices_offset];
+  } else {
+    num_indices = 0;
+  }
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_RenderGeometryRaw(
+    ren->handle,
+    tex.has_value() ? tex.value()->handle : nullptr,
+    reinterpret_cast<const float *>(&xy[xy_offset]),
+    xy_stride,
+    reinterpret_cast<const SDL_FColor *>(&color[color_offset]),
+    color_stride,
+    uv_ptr,
+    uv_stride,
+    num_vertices,
+    indices_ptr,
+    num_indices,
+    size_indices
+  );
+
+  bare_sdl__render_stats_end(&ren->stats, bare_sdl_render_phase_draw, start);
+
+  bare_sdl__render_stats_draw(&ren->stats);
+
+  return success;
 }
 
-// Rect
+// Keep in sync with lib/command-buffer.js
+enum {
+  bare_sdl_render_command_clear = 1,
+  bare_sdl_render_command_present = 2,
+  bare_sdl_render_command_set_draw_color = 3,
+  bare_sdl_render_command_fill_rect = 4,
+  bare_sdl_render_command_rect = 5,
+  bare_sdl_render_command_line = 6,
+  bare_sdl_render_command_clip = 7,
+  bare_sdl_render_command_texture = 8,
+};
 
-static js_arraybuffer_t
-bare_sdl_create_rect(
+static bool
+bare_sdl_render_commands(
   js_env_t *env,
   js_receiver_t,
-  int x,
-  int y,
-  int w,
-  int h
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  uint32_t len,
+  std::vector<js_arraybuffer_span_of_t<bare_sdl_texture_t, 1>> textures
 ) {
-  js_arraybuffer_t handle;
+  int err;
 
-  bare_sdl_rect_t *r;
-  int err = js_create_arraybuffer(env, r, handle);
-  assert(err == 0);
+  if (buf_offset + static_cast<size_t>(len) * sizeof(float) > buf.size()) {
+    err = js_throw_range_error(env, nullptr, "Command buffer out of bounds");
+    assert(err == 0);
 
-  r->handle.x = x;
-  r->handle.y = y;
-  r->handle.w = w;
-  r->handle.h = h;
+    throw js_pending_exception;
+  }
 
-  return handle;
-}
+  // Command buffers keep the handles of the textures they record, so check
+  // that none was destroyed since before issuing any draw.
+  for (auto &tex : textures) {
+    if (tex->handle == nullptr) {
+      err = js_throw_error(env, nullptr, "Recorded texture was destroyed");
+      assert(err == 0);
 
-static void
+      throw js_pending_exception;
+    }
+  }
+
+  auto commands = reinterpret_cast<const float *>(&buf[buf_offset]);
+
+  bool success = true;
+
+  uint32_t i = 0;
+
+  while (i < len) {
+    int op = static_cast<int>(commands[i++]);
+
+    uint32_t argc;
+
+    switch (op) {
+    case bare_sdl_render_command_clear:
+    case bare_sdl_render_command_present:
+      argc = 0;
+      break;
+    case bare_sdl_render_command_set_draw_color:
+    case bare_sdl_render_command_fill_rect:
+    case bare_sdl_render_command_rect:
+    case bare_sdl_render_command_line:
+    case bare_sdl_render_command_clip:
+      argc = 4;
+      break;
+    case bare_sdl_render_command_texture:
+      argc = 9;
+      break;
+    default:
+      err = js_throw_errorf(env, nullptr, "Unknown render command %d", op);
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+
+    if (len - i < argc) {
+      err = js_throw_range_error(env, nullptr, "Truncated render command");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+
+    const float *args = &commands[i];
+
+    i += argc;
+
+    uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+    int phase = bare_sdl_render_phase_draw;
+
+    switch (op) {
+    case bare_sdl_render_command_clear:
+      success &= SDL_RenderClear(ren->handle);
+      phase = bare_sdl_render_phase_clear;
+      break;
+
+    case bare_sdl_render_command_present:
+      success &= SDL_RenderPresent(ren->handle);
+      phase = bare_sdl_render_phase_present;
+      break;
+
+    case bare_sdl_render_command_set_draw_color:
+      success &= SDL_SetRenderDrawColorFloat(ren->handle, args[0], args[1], args[2], args[3]);
+      break;
+
+    case bare_sdl_render_command_fill_rect: {
+      SDL_FRect r = {args[0], args[1], args[2], args[3]};
+      success &= SDL_RenderFillRect(ren->handle, &r);
+      bare_sdl__render_stats_draw(&ren->stats);
+      break;
+    }
+
+    case bare_sdl_render_command_rect: {
+      SDL_FRect r = {args[0], args[1], args[2], args[3]};
+      success &= SDL_RenderRect(ren->handle, &r);
+      bare_sdl__render_stats_draw(&ren->stats);
+      break;
+    }
+
+    case bare_sdl_render_command_line:
+      success &= SDL_RenderLine(ren->handle, args[0], args[1], args[2], args[3]);
+      bare_sdl__render_stats_draw(&ren->stats);
+      break;
+
+    case bare_sdl_render_command_clip: {
+      // A negative width disables clipping
+      if (args[2] < 0) {
+        success &= SDL_SetRenderClipRect(ren->handle, nullptr);
+      } else {
+        SDL_Rect r = {int(args[0]), int(args[1]), int(args[2]), int(args[3])};
+        success &= SDL_SetRenderClipRect(ren->handle, &r);
+      }
+      break;
+    }
+
+    case bare_sdl_render_command_texture: {
+      auto index = static_cast<size_t>(args[0]);
+
+      if (args[0] < 0 || index >= textures.size()) {
+        err = js_throw_range_error(env, nullptr, "Texture index out of bounds");
+        assert(err == 0);
+
+        throw js_pending_exception;
+      }
+
+      // A negative width selects the entire texture or render target
+      SDL_FRect src = {args[1], args[2], args[3], args[4]};
+      SDL_FRect dst = {args[5], args[6], args[7], args[8]};
+
+      success &= SDL_RenderTexture(
+        ren->handle,
+        textures[index]->handle,
+        src.w < 0 ? nullptr : &src,
+        dst.w < 0 ? nullptr : &dst
+      );
+      bare_sdl__render_stats_draw(&ren->stats);
+      break;
+    }
+    }
+
+    bare_sdl__render_stats_end(&ren->stats, phase, start);
+
+    if (op == bare_sdl_render_command_present) bare_sdl__render_stats_commit(&ren->stats);
+  }
+
+  return success;
+}
+
+static void
+bare_sdl_enable_render_stats(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  if (ren->stats.enabled) return;
+
+  ren->stats = {};
+  ren->stats.enabled = true;
+}
+
+static void
+bare_sdl_disable_render_stats(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  ren->stats.enabled = false;
+}
+
+static void
+bare_sdl_reset_render_stats(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren
+) {
+  bool enabled = ren->stats.enabled;
+
+  ren->stats = {};
+  ren->stats.enabled = enabled;
+}
+
+// Writes the frame count followed by the p50, p95, p99, and max of each phase
+// in milliseconds, the draw calls, and the uploaded bytes per frame. Keep in
+// sync with lib/renderer.js.
+static void
+bare_sdl_get_render_stats(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset
+) {
+  int err;
+
+  constexpr size_t metrics = bare_sdl_render_phase_count + 2;
+
+  if (buf_offset + (1 + metrics * 4) * sizeof(double) > buf.size()) {
+    err = js_throw_range_error(env, nullptr, "Stats buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  auto &stats = ren->stats;
+
+  auto result = reinterpret_cast<double *>(&buf[buf_offset]);
+
+  *result++ = stats.count;
+
+  double ms = 1000.0 / SDL_GetPerformanceFrequency();
+
+  double samples[BARE_SDL_RENDER_STATS_FRAMES];
+
+  for (size_t metric = 0; metric < metrics; metric++) {
+    for (uint32_t i = 0; i < stats.count; i++) {
+      auto &frame = stats.frames[i];
+
+      if (metric < bare_sdl_render_phase_count) samples[i] = frame.phases[metric] * ms;
+      else if (metric == bare_sdl_render_phase_count) samples[i] = frame.draw_calls;
+      else samples[i] = frame.uploaded_bytes;
+    }
+
+    std::sort(samples, samples + stats.count);
+
+    for (double p : {0.5, 0.95, 0.99, 1.0}) {
+      *result++ = stats.count ? samples[static_cast<uint32_t>(p * (stats.count - 1) + 0.5)] : 0;
+    }
+  }
+}
+
+// Texture
+
+static SDL_PixelFormat
+bare_sdl__preferred_texture_format(SDL_Renderer *renderer) {
+  auto formats = static_cast<const SDL_PixelFormat *>(
+    SDL_GetPointerProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr)
+  );
+
+  if (formats == nullptr) return SDL_PIXELFORMAT_UNKNOWN;
+
+  // The renderer lists its formats in order of preference, so pick the first
+  // packed format that can be uploaded without conversion.
+  for (int i = 0; formats[i] != SDL_PIXELFORMAT_UNKNOWN; i++) {
+    if (SDL_ISPIXELFORMAT_FOURCC(formats[i]) || SDL_ISPIXELFORMAT_INDEXED(formats[i])) continue;
+
+    return formats[i];
+  }
+
+  return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+static size_t
+bare_sdl__texture_locked_size(SDL_PixelFormat format, int pitch, int h) {
+  size_t size = static_cast<size_t>(pitch) * static_cast<size_t>(h);
+
+  switch (format) {
+  case SDL_PIXELFORMAT_YV12:
+  case SDL_PIXELFORMAT_IYUV:
+    return size + 2 * static_cast<size_t>((pitch + 1) / 2) * static_cast<size_t>((h + 1) / 2);
+  case SDL_PIXELFORMAT_NV12:
+  case SDL_PIXELFORMAT_NV21:
+  case SDL_PIXELFORMAT_P010:
+    return size + static_cast<size_t>((pitch + 1) & ~1) * static_cast<size_t>((h + 1) / 2);
+  default:
+    return size;
+  }
+}
+
+static bool
+bare_sdl__texture_is_planar(SDL_PixelFormat format) {
+  switch (format) {
+  case SDL_PIXELFORMAT_YV12:
+  case SDL_PIXELFORMAT_IYUV:
+  case SDL_PIXELFORMAT_NV12:
+  case SDL_PIXELFORMAT_NV21:
+  case SDL_PIXELFORMAT_P010:
+    return true;
+  default:
+    return false;
+  }
+}
+
+static size_t
+bare_sdl__texture_upload_size(SDL_Texture *texture, const SDL_Rect *r) {
+  int w = r ? r->w : texture->w;
+  int h = r ? r->h : texture->h;
+
+  return bare_sdl__texture_locked_size(texture->format, w * SDL_BYTESPERPIXEL(texture->format), h);
+}
+
+// SDL offsets the locked pointer and reads update rects without clipping them
+// against the caller's buffer, so rects must lie entirely inside the texture.
+static void
+bare_sdl__check_texture_rect(js_env_t *env, SDL_Texture *texture, const SDL_Rect *r) {
+  int err;
+
+  if (r == nullptr) return;
+
+  if (r->w <= 0 || r->h <= 0 || r->x < 0 || r->y < 0 || r->x > texture->w - r->w || r->y > texture->h - r->h) {
+    err = js_throw_range_error(env, nullptr, "Rect out of bounds");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static void
+bare_sdl__check_texture_plane(js_env_t *env, size_t size, uint32_t offset, int pitch, int row, int rows) {
+  int err;
+
+  if (pitch < row) {
+    err = js_throw_range_error(env, nullptr, "Plane pitch too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (offset + static_cast<size_t>(pitch) * static_cast<size_t>(rows) > size) {
+    err = js_throw_range_error(env, nullptr, "Plane buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static js_arraybuffer_t
+bare_sdl_create_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  uint64_t pixel_format,
+  uint64_t texture_access,
+  int width,
+  int height
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  bare_sdl_texture_t *tex;
+  err = js_create_arraybuffer(env, tex, handle);
+  assert(err == 0);
+
+  auto format = static_cast<SDL_PixelFormat>(pixel_format);
+
+  if (format == SDL_PIXELFORMAT_UNKNOWN) {
+    format = bare_sdl__preferred_texture_format(ren->handle);
+
+    if (format == SDL_PIXELFORMAT_UNKNOWN) {
+      err = js_throw_error(env, nullptr, "Renderer reports no packed texture formats");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+  }
+
+  tex->handle = SDL_CreateTexture(
+    ren->handle,
+    format,
+    static_cast<SDL_TextureAccess>(texture_access),
+    width,
+    height
+  );
+
+  if (tex->handle == nullptr) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return handle;
+}
+
+static void
+bare_sdl_destroy_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex
+) {
+  SDL_DestroyTexture(tex->handle);
+
+  tex->handle = nullptr;
+}
+
+static bool
+bare_sdl_update_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int pitch,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect
+) {
+  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_UpdateTexture(tex->handle, r, &buf[buf_offset], pitch);
+
+  bare_sdl__render_stats_upload(&ren->stats, start, bare_sdl__texture_upload_size(tex->handle, r));
+
+  return success;
+}
+
+static bool
+bare_sdl_update_texture_rects(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int pitch,
+  js_arraybuffer_span_t rects_buf,
+  uint32_t rects_offset,
+  uint32_t rects_len,
+  bool merge
+) {
+  int err;
+
+  auto format = tex->handle->format;
+
+  if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+    err = js_throw_error(env, nullptr, "Texture format must be a packed pixel format");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (rects_offset + static_cast<size_t>(rects_len) * sizeof(SDL_Rect) > rects_buf.size()) {
+    err = js_throw_range_error(env, nullptr, "Rect buffer out of bounds");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  auto source = reinterpret_cast<const SDL_Rect *>(&rects_buf[rects_offset]);
+
+  SDL_Rect bounds = {0, 0, tex->handle->w, tex->handle->h};
+
+  std::vector<SDL_Rect> rects;
+  rects.reserve(rects_len);
+
+  for (uint32_t i = 0; i < rects_len; i++) {
+    SDL_Rect r;
+    if (SDL_GetRectIntersection(&source[i], &bounds, &r)) rects.push_back(r);
+  }
+
+  if (merge) {
+    // Repeatedly fold overlapping rects into each other until every remaining
+    // rect is disjoint, as a union may come to overlap rects already visited.
+    bool merged;
+
+    do {
+      merged = false;
+
+      for (size_t i = 0; i < rects.size(); i++) {
+        for (size_t j = i + 1; j < rects.size();) {
+          if (SDL_HasRectIntersection(&rects[i], &rects[j])) {
+            SDL_GetRectUnion(&rects[i], &rects[j], &rects[i]);
+            rects.erase(rects.begin() + j);
+            merged = true;
+          } else {
+            j++;
+          }
+        }
+      }
+    } while (merged);
+  }
+
+  size_t bpp = SDL_BYTESPERPIXEL(format);
+
+  // Validate every rect up front so a bad rect does not leave the texture
+  // partially updated.
+  for (auto &r : rects) {
+    if (pitch <= 0 || static_cast<size_t>(pitch) < r.w * bpp) {
+      err = js_throw_range_error(env, nullptr, "Pitch too small");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+
+    size_t end = static_cast<size_t>(r.y + r.h - 1) * pitch + (r.x + r.w) * bpp;
+
+    if (buf_offset + end > buf.size()) {
+      err = js_throw_range_error(env, nullptr, "Pixel buffer too small");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+  }
+
+  uint64_t started = bare_sdl__render_stats_begin(&ren->stats);
+
+  size_t uploaded = 0;
+
+  bool success = true;
+
+  for (auto &r : rects) {
+    size_t start = static_cast<size_t>(r.y) * pitch + r.x * bpp;
+
+    success &= SDL_UpdateTexture(tex->handle, &r, &buf[buf_offset + start], pitch);
+
+    uploaded += static_cast<size_t>(r.w) * r.h * bpp;
+  }
+
+  bare_sdl__render_stats_upload(&ren->stats, started, uploaded);
+
+  return success;
+}
+
+static bool
+bare_sdl_convert_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int pitch,
+  uint32_t pixel_format,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect
+) {
+  int err;
+
+  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
+
+  bare_sdl__check_texture_rect(env, tex->handle, r);
+
+  int w = r ? r->w : tex->handle->w;
+  int h = r ? r->h : tex->handle->h;
+
+  auto src_format = static_cast<SDL_PixelFormat>(pixel_format);
+
+  // For planar formats this is the row size of the Y plane.
+  if (pitch < w * SDL_BYTESPERPIXEL(src_format)) {
+    err = js_throw_range_error(env, nullptr, "Pitch too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (buf_offset + bare_sdl__texture_locked_size(src_format, pitch, h) > buf.size()) {
+    err = js_throw_range_error(env, nullptr, "Pixel buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  auto access = SDL_GetNumberProperty(SDL_GetTextureProperties(tex->handle), SDL_PROP_TEXTURE_ACCESS_NUMBER, SDL_TEXTUREACCESS_STATIC);
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  size_t uploaded = bare_sdl__texture_upload_size(tex->handle, r);
+
+  // Streaming textures are converted straight into the locked texture memory,
+  // avoiding the intermediate copy SDL_UpdateTexture would otherwise make.
+  if (access == SDL_TEXTUREACCESS_STREAMING && tex->pitch == 0) {
+    void *pixels;
+    int locked_pitch;
+
+    if (!SDL_LockTexture(tex->handle, r, &pixels, &locked_pitch)) return false;
+
+    bool success = SDL_ConvertPixels(w, h, src_format, &buf[buf_offset], pitch, tex->handle->format, pixels, locked_pitch);
+
+    SDL_UnlockTexture(tex->handle);
+
+    bare_sdl__render_stats_upload(&ren->stats, start, uploaded);
+
+    return success;
+  }
+
+  int converted_pitch = w * SDL_BYTESPERPIXEL(tex->handle->format);
+
+  void *converted = SDL_malloc(bare_sdl__texture_locked_size(tex->handle->format, converted_pitch, h));
+
+  if (converted == nullptr) return false;
+
+  bool success = SDL_ConvertPixels(w, h, src_format, &buf[buf_offset], pitch, tex->handle->format, converted, converted_pitch) &&
+                 SDL_UpdateTexture(tex->handle, r, converted, converted_pitch);
+
+  SDL_free(converted);
+
+  bare_sdl__render_stats_upload(&ren->stats, start, uploaded);
+
+  return success;
+}
+
+static uint32_t
+bare_sdl_get_texture_format(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex
+) {
+  return tex->handle->format;
+}
+
+static bool
+bare_sdl_update_yuv_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t y_buf,
+  uint32_t y_offset,
+  int y_pitch,
+  js_arraybuffer_span_t u_buf,
+  uint32_t u_offset,
+  int u_pitch,
+  js_arraybuffer_span_t v_buf,
+  uint32_t v_offset,
+  int v_pitch,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect
+) {
+  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
+
+  bare_sdl__check_texture_rect(env, tex->handle, r);
+
+  int w = r ? r->w : tex->handle->w;
+  int h = r ? r->h : tex->handle->h;
+
+  bare_sdl__check_texture_plane(env, y_buf.size(), y_offset, y_pitch, w, h);
+  bare_sdl__check_texture_plane(env, u_buf.size(), u_offset, u_pitch, (w + 1) / 2, (h + 1) / 2);
+  bare_sdl__check_texture_plane(env, v_buf.size(), v_offset, v_pitch, (w + 1) / 2, (h + 1) / 2);
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_UpdateYUVTexture(
+    tex->handle,
+    r,
+    &y_buf[y_offset],
+    y_pitch,
+    &u_buf[u_offset],
+    u_pitch,
+    &v_buf[v_offset],
+    v_pitch
+  );
+
+  bare_sdl__render_stats_upload(&ren->stats, start, bare_sdl__texture_upload_size(tex->handle, r));
+
+  return success;
+}
+
+static bool
+bare_sdl_update_nv_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_span_t y_buf,
+  uint32_t y_offset,
+  int y_pitch,
+  js_arraybuffer_span_t uv_buf,
+  uint32_t uv_offset,
+  int uv_pitch,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect
+) {
+  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
+
+  bare_sdl__check_texture_rect(env, tex->handle, r);
+
+  int w = r ? r->w : tex->handle->w;
+  int h = r ? r->h : tex->handle->h;
+
+  // P010 stores 16-bit samples, the 8-bit formats one byte per sample.
+  int bps = SDL_BYTESPERPIXEL(tex->handle->format);
+
+  bare_sdl__check_texture_plane(env, y_buf.size(), y_offset, y_pitch, w * bps, h);
+  bare_sdl__check_texture_plane(env, uv_buf.size(), uv_offset, uv_pitch, 2 * ((w + 1) / 2) * bps, (h + 1) / 2);
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  bool success = SDL_UpdateNVTexture(
+    tex->handle,
+    r,
+    &y_buf[y_offset],
+    y_pitch,
+    &uv_buf[uv_offset],
+    uv_pitch
+  );
+
+  bare_sdl__render_stats_upload(&ren->stats, start, bare_sdl__texture_upload_size(tex->handle, r));
+
+  return success;
+}
+
+static js_arraybuffer_t
+bare_sdl_lock_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_rect_t, 1>> rect
+) {
+  int err;
+
+  const SDL_Rect *r = rect.has_value() ? &rect.value()->handle : nullptr;
+
+  // The chroma planes of a locked sub-region still sit at offsets computed
+  // from the full texture height, so the region cannot be exposed as a
+  // single contiguous buffer.
+  if (r && bare_sdl__texture_is_planar(tex->handle->format)) {
+    err = js_throw_error(env, nullptr, "Planar textures can only be locked in full");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  bare_sdl__check_texture_rect(env, tex->handle, r);
+
+  void *pixels;
+  int pitch;
+
+  if (!SDL_LockTexture(tex->handle, r, &pixels, &pitch)) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  tex->pitch = pitch;
+
+  // A sub-region lock points at its first pixel, so the buffer may only reach
+  // the last pixel of its last row rather than a whole pitch past it.
+  if (r) {
+    tex->locked_size = static_cast<size_t>(pitch) * (r->h - 1) + static_cast<size_t>(r->w) * SDL_BYTESPERPIXEL(tex->handle->format);
+  } else {
+    tex->locked_size = bare_sdl__texture_locked_size(tex->handle->format, pitch, tex->handle->h);
+  }
+
+  js_value_t *handle;
+  err = js_create_external_arraybuffer(
+    env,
+    pixels,
+    tex->locked_size,
+    nullptr,
+    nullptr,
+    &handle
+  );
+  assert(err == 0);
+
+  return js_arraybuffer_t(handle);
+}
+
+static void
+bare_sdl_unlock_texture(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex,
+  js_arraybuffer_span_of_t<bare_sdl_renderer_t, 1> ren,
+  js_arraybuffer_t pixels
+) {
+  int err;
+
+  // The locked memory belongs to the renderer once unlocked, so detach the
+  // buffer to prevent any further access from JavaScript.
+  err = js_detach_arraybuffer(env, pixels);
+  assert(err == 0);
+
+  uint64_t start = bare_sdl__render_stats_begin(&ren->stats);
+
+  SDL_UnlockTexture(tex->handle);
+
+  bare_sdl__render_stats_upload(&ren->stats, start, tex->locked_size);
+
+  tex->pitch = 0;
+  tex->locked_size = 0;
+}
+
+static int
+bare_sdl_get_texture_pitch(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_texture_t, 1> tex
+) {
+  return tex->pitch;
+}
+
+// Rect
+
+static js_arraybuffer_t
+bare_sdl_create_rect(
+  js_env_t *env,
+  js_receiver_t,
+  int x,
+  int y,
+  int w,
+  int h
+) {
+  js_arraybuffer_t handle;
+
+  bare_sdl_rect_t *r;
+  int err = js_create_arraybuffer(env, r, handle);
+  assert(err == 0);
+
+  r->handle.x = x;
+  r->handle.y = y;
+  r->handle.w = w;
+  r->handle.h = h;
+
+  return handle;
+}
+
+static void
 bare_sdl_set_rect(
   js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r,
-  int x,
-  int y,
-  int w,
-  int h
+  js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r,
+  int x,
+  int y,
+  int w,
+  int h
+) {
+  r->handle.x = x;
+  r->handle.y = y;
+  r->handle.w = w;
+  r->handle.h = h;
+}
+
+static int
+bare_sdl_get_rect_x(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
+  return r->handle.x;
+}
+
+static int
+bare_sdl_get_rect_y(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
+  return r->handle.y;
+}
+
+static int
+bare_sdl_get_rect_w(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
+  return r->handle.w;
+}
+
+static int
+bare_sdl_get_rect_h(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
+  return r->handle.h;
+}
+
+// FRect
+
+static js_arraybuffer_t
+bare_sdl_create_frect(
+  js_env_t *env,
+  js_receiver_t,
+  double x,
+  double y,
+  double w,
+  double h
+) {
+  js_arraybuffer_t handle;
+
+  bare_sdl_frect_t *r;
+  int err = js_create_arraybuffer(env, r, handle);
+  assert(err == 0);
+
+  r->handle.x = static_cast<float>(x);
+  r->handle.y = static_cast<float>(y);
+  r->handle.w = static_cast<float>(w);
+  r->handle.h = static_cast<float>(h);
+
+  return handle;
+}
+
+static void
+bare_sdl_set_frect(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r,
+  double x,
+  double y,
+  double w,
+  double h
+) {
+  r->handle.x = static_cast<float>(x);
+  r->handle.y = static_cast<float>(y);
+  r->handle.w = static_cast<float>(w);
+  r->handle.h = static_cast<float>(h);
+}
+
+static double
+bare_sdl_get_frect_x(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
+  return r->handle.x;
+}
+
+static double
+bare_sdl_get_frect_y(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
+  return r->handle.y;
+}
+
+static double
+bare_sdl_get_frect_w(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
+  return r->handle.w;
+}
+
+static double
+bare_sdl_get_frect_h(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
+  return r->handle.h;
+}
+
+// Frame scheduler
+
+static void
+bare_sdl__on_frame_scheduler_timer(uv_timer_t *handle);
+
+// Handles are allocated separately from the ArrayBuffer that owns them, as
+// libuv still references them after uv_close() until this callback runs,
+// which may be after the ArrayBuffer has been collected.
+static void
+bare_sdl__on_handle_close(uv_handle_t *handle) {
+  SDL_free(handle);
+}
+
+static void
+bare_sdl__schedule_frame(bare_sdl_frame_scheduler_t *scheduler) {
+  uint64_t now = SDL_GetTicksNS();
+
+  // libuv timers have millisecond resolution and never fire early, so round
+  // down and let the frame start up to a millisecond ahead of its slot.
+  uint64_t delay = scheduler->start > now ? (scheduler->start - now) / SDL_NS_PER_MS : 0;
+
+  int err = uv_timer_start(scheduler->timer, bare_sdl__on_frame_scheduler_timer, delay, 0);
+  assert(err == 0);
+}
+
+static void
+bare_sdl__on_frame_scheduler_timer(uv_timer_t *handle) {
+  int err;
+
+  auto scheduler = reinterpret_cast<bare_sdl_frame_scheduler_t *>(handle->data);
+  auto env = scheduler->env;
+
+  uint64_t now = SDL_GetTicksNS();
+
+  // Any whole intervals that elapsed past the scheduled start are frames the
+  // display presented without a new one from us.
+  uint64_t skipped = now > scheduler->start ? (now - scheduler->start) / scheduler->interval : 0;
+
+  scheduler->start += skipped * scheduler->interval;
+  scheduler->frames++;
+  scheduler->skipped += skipped;
+
+  uint64_t deadline = scheduler->start + scheduler->interval;
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  bare_sdl_frame_scheduler_callback_t callback;
+  err = js_get_reference_value(env, scheduler->on_frame, callback);
+  assert(err == 0);
+
+  js_call_function(env, callback, double(deadline) / SDL_NS_PER_MS, uint32_t(skipped));
+
+  js_close_handle_scope(env, scope);
+
+  uint64_t end = SDL_GetTicksNS();
+
+  scheduler->frame_time = end - now;
+
+  if (!scheduler->active) return;
+
+  scheduler->start = deadline;
+
+  // If presenting blocked past the nominal deadline, but by less than a full
+  // interval, vsync is holding us to the display; follow its phase.
+  if (end > deadline && end - deadline < scheduler->interval) scheduler->start = end;
+
+  bare_sdl__schedule_frame(scheduler);
+}
+
+static js_arraybuffer_t
+bare_sdl_create_frame_scheduler(
+  js_env_t *env,
+  js_receiver_t,
+  std::optional<js_arraybuffer_span_of_t<bare_sdl_window_t, 1>> win,
+  std::optional<double> rate,
+  bare_sdl_frame_scheduler_callback_t on_frame
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  bare_sdl_frame_scheduler_t *scheduler;
+  err = js_create_arraybuffer(env, scheduler, handle);
+  assert(err == 0);
+
+  double refresh_rate = rate.value_or(0);
+
+  if (refresh_rate <= 0) {
+    SDL_DisplayID display = win.has_value() ? SDL_GetDisplayForWindow(win.value()->handle) : SDL_GetPrimaryDisplay();
+
+    const SDL_DisplayMode *mode = display ? SDL_GetCurrentDisplayMode(display) : nullptr;
+
+    if (mode && mode->refresh_rate_numerator > 0 && mode->refresh_rate_denominator > 0) {
+      refresh_rate = double(mode->refresh_rate_numerator) / mode->refresh_rate_denominator;
+    } else if (mode && mode->refresh_rate > 0) {
+      refresh_rate = mode->refresh_rate;
+    } else {
+      refresh_rate = 60;
+    }
+  }
+
+  scheduler->timer = reinterpret_cast<uv_timer_t *>(SDL_malloc(sizeof(uv_timer_t)));
+
+  if (scheduler->timer == nullptr) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  scheduler->env = env;
+  scheduler->interval = uint64_t(SDL_NS_PER_SECOND / refresh_rate);
+
+  err = js_create_reference(env, on_frame, scheduler->on_frame);
+  assert(err == 0);
+
+  uv_loop_t *loop;
+  err = js_get_env_loop(env, &loop);
+  assert(err == 0);
+
+  err = uv_timer_init(loop, scheduler->timer);
+  assert(err == 0);
+
+  scheduler->timer->data = scheduler;
+
+  return handle;
+}
+
+static void
+bare_sdl_start_frame_scheduler(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  if (scheduler->active) return;
+
+  scheduler->active = true;
+  scheduler->start = SDL_GetTicksNS();
+
+  bare_sdl__schedule_frame(scheduler);
+}
+
+static void
+bare_sdl_stop_frame_scheduler(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  scheduler->active = false;
+
+  uv_timer_stop(scheduler->timer);
+}
+
+static void
+bare_sdl_destroy_frame_scheduler(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  scheduler->active = false;
+  scheduler->on_frame.reset();
+
+  uv_close(reinterpret_cast<uv_handle_t *>(scheduler->timer), bare_sdl__on_handle_close);
+}
+
+static double
+bare_sdl_get_frame_scheduler_interval(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  return double(scheduler->interval) / SDL_NS_PER_MS;
+}
+
+static double
+bare_sdl_get_frame_scheduler_frames(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  return double(scheduler->frames);
+}
+
+static double
+bare_sdl_get_frame_scheduler_skipped(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  return double(scheduler->skipped);
+}
+
+static double
+bare_sdl_get_frame_scheduler_frame_time(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_frame_scheduler_t, 1> scheduler
+) {
+  return double(scheduler->frame_time) / SDL_NS_PER_MS;
+}
+
+static double
+bare_sdl_get_ticks(
+  js_env_t *,
+  js_receiver_t
+) {
+  return double(SDL_GetTicksNS()) / SDL_NS_PER_MS;
+}
+
+// Gamepad
+
+// Gamepad state shared with JavaScript as an Int32Array of fixed slots, each
+// holding the joystick ID, the axes, and the button mask of an open gamepad.
+// Keep in sync with lib/gamepad.js.
+#define BARE_SDL_GAMEPAD_SLOTS         8
+#define BARE_SDL_GAMEPAD_SLOT_SIZE     8
+#define BARE_SDL_GAMEPAD_SLOT_AXES     1
+#define BARE_SDL_GAMEPAD_SLOT_BUTTONS  7
+
+static_assert(BARE_SDL_GAMEPAD_SLOT_AXES + SDL_GAMEPAD_AXIS_COUNT <= BARE_SDL_GAMEPAD_SLOT_BUTTONS);
+static_assert(SDL_GAMEPAD_BUTTON_COUNT <= 32);
+
+static int32_t bare_sdl__gamepad_state[BARE_SDL_GAMEPAD_SLOTS][BARE_SDL_GAMEPAD_SLOT_SIZE];
+static SDL_Gamepad *bare_sdl__gamepads[BARE_SDL_GAMEPAD_SLOTS];
+
+static bool bare_sdl__gamepads_enabled = false;
+static std::atomic<bool> bare_sdl__gamepads_changed;
+
+static bool SDLCALL
+bare_sdl__on_gamepad_watch(void *, SDL_Event *event) {
+  if (event->type == SDL_EVENT_GAMEPAD_ADDED || event->type == SDL_EVENT_GAMEPAD_REMOVED) {
+    bare_sdl__gamepads_changed = true;
+  }
+
+  return true;
+}
+
+static void
+bare_sdl__sync_gamepads() {
+  int count;
+  SDL_JoystickID *ids = SDL_GetGamepads(&count);
+
+  if (ids == nullptr) return;
+
+  for (int slot = 0; slot < BARE_SDL_GAMEPAD_SLOTS; slot++) {
+    SDL_Gamepad *gamepad = bare_sdl__gamepads[slot];
+
+    if (gamepad == nullptr || SDL_GamepadConnected(gamepad)) continue;
+
+    SDL_CloseGamepad(gamepad);
+
+    bare_sdl__gamepads[slot] = nullptr;
+
+    memset(bare_sdl__gamepad_state[slot], 0, sizeof(bare_sdl__gamepad_state[slot]));
+  }
+
+  for (int i = 0; i < count; i++) {
+    int available = -1;
+    bool open = false;
+
+    for (int slot = 0; slot < BARE_SDL_GAMEPAD_SLOTS; slot++) {
+      if (bare_sdl__gamepads[slot] == nullptr) {
+        if (available == -1) available = slot;
+      } else if (bare_sdl__gamepad_state[slot][0] == int32_t(ids[i])) {
+        open = true;
+      }
+    }
+
+    if (open || available == -1) continue;
+
+    SDL_Gamepad *gamepad = SDL_OpenGamepad(ids[i]);
+
+    if (gamepad == nullptr) continue;
+
+    bare_sdl__gamepads[available] = gamepad;
+    bare_sdl__gamepad_state[available][0] = int32_t(ids[i]);
+  }
+
+  SDL_free(ids);
+}
+
+static void
+bare_sdl__refresh_gamepad_state() {
+  if (!bare_sdl__gamepads_enabled) return;
+
+  if (bare_sdl__gamepads_changed.exchange(false)) bare_sdl__sync_gamepads();
+
+  for (int slot = 0; slot < BARE_SDL_GAMEPAD_SLOTS; slot++) {
+    SDL_Gamepad *gamepad = bare_sdl__gamepads[slot];
+
+    if (gamepad == nullptr) continue;
+
+    int32_t *state = bare_sdl__gamepad_state[slot];
+
+    for (int axis = 0; axis < SDL_GAMEPAD_AXIS_COUNT; axis++) {
+      state[BARE_SDL_GAMEPAD_SLOT_AXES + axis] = SDL_GetGamepadAxis(gamepad, SDL_GamepadAxis(axis));
+    }
+
+    uint32_t buttons = 0;
+
+    for (int button = 0; button < SDL_GAMEPAD_BUTTON_COUNT; button++) {
+      if (SDL_GetGamepadButton(gamepad, SDL_GamepadButton(button))) buttons |= 1u << button;
+    }
+
+    state[BARE_SDL_GAMEPAD_SLOT_BUTTONS] = int32_t(buttons);
+  }
+}
+
+static js_arraybuffer_t
+bare_sdl_get_gamepad_state(
+  js_env_t *env,
+  js_receiver_t
+) {
+  int err;
+
+  if (!bare_sdl__gamepads_enabled) {
+    bare_sdl__gamepads_enabled = true;
+    bare_sdl__gamepads_changed = true;
+
+    SDL_AddEventWatch(bare_sdl__on_gamepad_watch, nullptr);
+
+    SDL_UpdateGamepads();
+
+    bare_sdl__refresh_gamepad_state();
+  }
+
+  js_value_t *handle;
+  err = js_create_external_arraybuffer(env, bare_sdl__gamepad_state, sizeof(bare_sdl__gamepad_state), nullptr, nullptr, &handle);
+  assert(err == 0);
+
+  return js_arraybuffer_t(handle);
+}
+
+static js_arraybuffer_t
+bare_sdl_attach_virtual_joystick(
+  js_env_t *env,
+  js_receiver_t,
+  std::optional<std::string> name
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  bare_sdl_virtual_joystick_t *joystick;
+  err = js_create_arraybuffer(env, joystick, handle);
+  assert(err == 0);
+
+  SDL_VirtualJoystickDesc desc;
+  SDL_INIT_INTERFACE(&desc);
+
+  // Expose the standard gamepad layout so SDL maps the joystick as a gamepad.
+  desc.type = SDL_JOYSTICK_TYPE_GAMEPAD;
+  desc.naxes = SDL_GAMEPAD_AXIS_COUNT;
+  desc.nbuttons = SDL_GAMEPAD_BUTTON_COUNT;
+  desc.name = name.has_value() ? name->c_str() : "Virtual Gamepad";
+
+  joystick->id = SDL_AttachVirtualJoystick(&desc);
+
+  if (joystick->id == 0) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  joystick->handle = SDL_OpenJoystick(joystick->id);
+
+  if (joystick->handle == nullptr) {
+    SDL_DetachVirtualJoystick(joystick->id);
+
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return handle;
+}
+
+static void
+bare_sdl_detach_virtual_joystick(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_virtual_joystick_t, 1> joystick
+) {
+  SDL_CloseJoystick(joystick->handle);
+  SDL_DetachVirtualJoystick(joystick->id);
+}
+
+static uint32_t
+bare_sdl_get_virtual_joystick_id(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_virtual_joystick_t, 1> joystick
+) {
+  return joystick->id;
+}
+
+static bool
+bare_sdl_set_virtual_joystick_axis(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_virtual_joystick_t, 1> joystick,
+  int axis,
+  int value
+) {
+  return SDL_SetJoystickVirtualAxis(joystick->handle, axis, int16_t(std::clamp(value, SDL_JOYSTICK_AXIS_MIN, SDL_JOYSTICK_AXIS_MAX)));
+}
+
+static bool
+bare_sdl_set_virtual_joystick_button(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_virtual_joystick_t, 1> joystick,
+  int button,
+  bool down
+) {
+  return SDL_SetJoystickVirtualButton(joystick->handle, button, down);
+}
+
+// Events
+
+// Event records are fixed 64 byte structures decoded from SDL_Event so that
+// JavaScript can read their fields through a DataView. Batches store records
+// as columns of 32 bit words, word k of record i being word k * capacity + i,
+// so that a single field of every event can be read as one typed array.
+// Strings are copied to a heap following the records and referenced by offset
+// and length. Keep in sync with lib/event.js.
+#define BARE_SDL_EVENT_RECORD_SIZE 64
+
+typedef struct {
+  uint8_t *data;
+  uint32_t size;
+  uint32_t used;
+} bare_sdl_event_heap_t;
+
+template <typename T>
+static inline void
+bare_sdl__write_record(uint8_t *record, size_t offset, T value) {
+  memcpy(&record[offset], &value, sizeof(T));
+}
+
+template <typename T>
+static inline T
+bare_sdl__read_record(const uint8_t *record, size_t offset) {
+  T value;
+  memcpy(&value, &record[offset], sizeof(T));
+  return value;
+}
+
+static void
+bare_sdl__write_record_string(uint8_t *record, bare_sdl_event_heap_t *heap, const char *str) {
+  if (str == nullptr) return;
+
+  size_t len = strlen(str);
+  size_t available = heap->size - heap->used;
+
+  if (len > available) {
+    len = available;
+
+    // Don't split a multibyte character when truncating.
+    while (len > 0 && (static_cast<uint8_t>(str[len]) & 0xc0) == 0x80) len--;
+
+    bare_sdl__write_record<uint8_t>(record, 50, 1);
+  }
+
+  memcpy(&heap->data[heap->used], str, len);
+
+  bare_sdl__write_record<uint32_t>(record, 40, heap->used);
+  bare_sdl__write_record<uint32_t>(record, 44, uint32_t(len));
+
+  heap->used += uint32_t(len);
+}
+
+static void
+bare_sdl__encode_event(const SDL_Event *e, uint8_t *record, bare_sdl_event_heap_t *heap) {
+  memset(record, 0, BARE_SDL_EVENT_RECORD_SIZE);
+
+  bare_sdl__write_record<uint32_t>(record, 0, e->type);
+  bare_sdl__write_record<uint64_t>(record, 8, e->common.timestamp);
+
+  if (e->type >= SDL_EVENT_WINDOW_FIRST && e->type <= SDL_EVENT_WINDOW_LAST) {
+    bare_sdl__write_record<uint32_t>(record, 4, e->window.windowID);
+    bare_sdl__write_record<int32_t>(record, 20, e->window.data1);
+    bare_sdl__write_record<int32_t>(record, 24, e->window.data2);
+    return;
+  }
+
+  if (e->type >= SDL_EVENT_DISPLAY_FIRST && e->type <= SDL_EVENT_DISPLAY_LAST) {
+    bare_sdl__write_record<uint32_t>(record, 16, e->display.displayID);
+    bare_sdl__write_record<int32_t>(record, 20, e->display.data1);
+    bare_sdl__write_record<int32_t>(record, 24, e->display.data2);
+    return;
+  }
+
+  switch (e->type) {
+  case SDL_EVENT_KEY_DOWN:
+  case SDL_EVENT_KEY_UP:
+    bare_sdl__write_record<uint32_t>(record, 4, e->key.windowID);
+    bare_sdl__write_record<uint32_t>(record, 16, e->key.which);
+    bare_sdl__write_record<uint32_t>(record, 20, e->key.scancode);
+    bare_sdl__write_record<uint32_t>(record, 24, e->key.key);
+    bare_sdl__write_record<uint16_t>(record, 28, e->key.mod);
+    bare_sdl__write_record<uint8_t>(record, 48, e->key.down);
+    bare_sdl__write_record<uint8_t>(record, 49, e->key.repeat);
+    break;
+
+  case SDL_EVENT_MOUSE_MOTION:
+    bare_sdl__write_record<uint32_t>(record, 4, e->motion.windowID);
+    bare_sdl__write_record<uint32_t>(record, 16, e->motion.which);
+    bare_sdl__write_record<uint32_t>(record, 20, e->motion.state);
+    bare_sdl__write_record<float>(record, 24, e->motion.x);
+    bare_sdl__write_record<float>(record, 28, e->motion.y);
+    bare_sdl__write_record<float>(record, 32, e->motion.xrel);
+    bare_sdl__write_record<float>(record, 36, e->motion.yrel);
+    break;
+
+  case SDL_EVENT_MOUSE_BUTTON_DOWN:
+  case SDL_EVENT_MOUSE_BUTTON_UP:
+    bare_sdl__write_record<uint32_t>(record, 4, e->button.windowID);
+    bare_sdl__write_record<uint32_t>(record, 16, e->button.which);
+    bare_sdl__write_record<uint8_t>(record, 20, e->button.button);
+    bare_sdl__write_record<uint8_t>(record, 22, e->button.clicks);
+    bare_sdl__write_record<float>(record, 24, e->button.x);
+    bare_sdl__write_record<float>(record, 28, e->button.y);
+    bare_sdl__write_record<uint8_t>(record, 48, e->button.down);
+    break;
+
+  case SDL_EVENT_MOUSE_WHEEL:
+    bare_sdl__write_record<uint32_t>(record, 4, e->wheel.windowID);
+    bare_sdl__write_record<uint32_t>(record, 16, e->wheel.which);
+    bare_sdl__write_record<uint32_t>(record, 20, e->wheel.direction);
+    bare_sdl__write_record<float>(record, 24, e->wheel.mouse_x);
+    bare_sdl__write_record<float>(record, 28, e->wheel.mouse_y);
+    bare_sdl__write_record<float>(record, 32, e->wheel.x);
+    bare_sdl__write_record<float>(record, 36, e->wheel.y);
+    break;
+
+  case SDL_EVENT_PEN_MOTION:
+    bare_sdl__write_record<uint32_t>(record, 4, e->pmotion.windowID);
+    bare_sdl__write_record<uint32_t>(record, 16, e->pmotion.which);
+    bare_sdl__write_record<uint32_t>(record, 20, e->pmotion.pen_state);
+    bare_sdl__write_record<float>(record, 24, e->pmotion.x);
+    bare_sdl__write_record<float>(record, 28, e->pmotion.y);
+    break;
+
+  case SDL_EVENT_KEYBOARD_ADDED:
+  case SDL_EVENT_KEYBOARD_REMOVED:
+    bare_sdl__write_record<uint32_t>(record, 16, e->kdevice.which);
+    break;
+
+  case SDL_EVENT_MOUSE_ADDED:
+  case SDL_EVENT_MOUSE_REMOVED:
+    bare_sdl__write_record<uint32_t>(record, 16, e->mdevice.which);
+    break;
+
+  case SDL_EVENT_TEXT_INPUT:
+    bare_sdl__write_record<uint32_t>(record, 4, e->text.windowID);
+    bare_sdl__write_record_string(record, heap, e->text.text);
+    break;
+
+  case SDL_EVENT_TEXT_EDITING:
+    bare_sdl__write_record<uint32_t>(record, 4, e->edit.windowID);
+    bare_sdl__write_record<int32_t>(record, 20, e->edit.start);
+    bare_sdl__write_record<int32_t>(record, 24, e->edit.length);
+    bare_sdl__write_record_string(record, heap, e->edit.text);
+    break;
+
+  case SDL_EVENT_DROP_BEGIN:
+  case SDL_EVENT_DROP_FILE:
+  case SDL_EVENT_DROP_TEXT:
+  case SDL_EVENT_DROP_COMPLETE:
+  case SDL_EVENT_DROP_POSITION:
+    bare_sdl__write_record<uint32_t>(record, 4, e->drop.windowID);
+    bare_sdl__write_record<float>(record, 24, e->drop.x);
+    bare_sdl__write_record<float>(record, 28, e->drop.y);
+    bare_sdl__write_record_string(record, heap, e->drop.data);
+    break;
+
+  case SDL_EVENT_AUDIO_DEVICE_ADDED:
+  case SDL_EVENT_AUDIO_DEVICE_REMOVED:
+  case SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED:
+    bare_sdl__write_record<uint32_t>(record, 16, e->adevice.which);
+    bare_sdl__write_record<uint8_t>(record, 48, e->adevice.recording);
+    break;
+
+  case SDL_EVENT_CAMERA_DEVICE_ADDED:
+  case SDL_EVENT_CAMERA_DEVICE_REMOVED:
+  case SDL_EVENT_CAMERA_DEVICE_APPROVED:
+  case SDL_EVENT_CAMERA_DEVICE_DENIED:
+    bare_sdl__write_record<uint32_t>(record, 16, e->cdevice.which);
+    break;
+
+  case SDL_EVENT_JOYSTICK_ADDED:
+  case SDL_EVENT_JOYSTICK_REMOVED:
+    bare_sdl__write_record<uint32_t>(record, 16, e->jdevice.which);
+    break;
+
+  case SDL_EVENT_GAMEPAD_ADDED:
+  case SDL_EVENT_GAMEPAD_REMOVED:
+  case SDL_EVENT_GAMEPAD_REMAPPED:
+    bare_sdl__write_record<uint32_t>(record, 16, e->gdevice.which);
+    break;
+
+  case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+    bare_sdl__write_record<uint32_t>(record, 16, e->gaxis.which);
+    bare_sdl__write_record<uint8_t>(record, 20, e->gaxis.axis);
+    bare_sdl__write_record<int32_t>(record, 24, e->gaxis.value);
+    break;
+
+  case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+  case SDL_EVENT_GAMEPAD_BUTTON_UP:
+    bare_sdl__write_record<uint32_t>(record, 16, e->gbutton.which);
+    bare_sdl__write_record<uint8_t>(record, 20, e->gbutton.button);
+    bare_sdl__write_record<uint8_t>(record, 48, e->gbutton.down);
+    break;
+  }
+}
+
+static inline void
+bare_sdl__store_record(uint8_t *columns, uint32_t capacity, uint32_t index, const uint8_t *record) {
+  for (size_t k = 0; k < BARE_SDL_EVENT_RECORD_SIZE / 4; k++) {
+    memcpy(&columns[(k * capacity + index) * 4], &record[k * 4], 4);
+  }
+}
+
+// Folds a motion event into the previous record if it describes motion of
+// the same device in the same window, keeping the latest position and state
+// while accumulating the relative motion.
+static bool
+bare_sdl__coalesce_event(const SDL_Event *e, uint8_t *previous) {
+  if (bare_sdl__read_record<uint32_t>(previous, 0) != e->type) return false;
+
+  switch (e->type) {
+  case SDL_EVENT_MOUSE_MOTION:
+    if (bare_sdl__read_record<uint32_t>(previous, 4) != e->motion.windowID) return false;
+    if (bare_sdl__read_record<uint32_t>(previous, 16) != e->motion.which) return false;
+
+    bare_sdl__write_record<uint64_t>(previous, 8, e->motion.timestamp);
+    bare_sdl__write_record<uint32_t>(previous, 20, e->motion.state);
+    bare_sdl__write_record<float>(previous, 24, e->motion.x);
+    bare_sdl__write_record<float>(previous, 28, e->motion.y);
+    bare_sdl__write_record<float>(previous, 32, bare_sdl__read_record<float>(previous, 32) + e->motion.xrel);
+    bare_sdl__write_record<float>(previous, 36, bare_sdl__read_record<float>(previous, 36) + e->motion.yrel);
+    return true;
+
+  case SDL_EVENT_PEN_MOTION:
+    if (bare_sdl__read_record<uint32_t>(previous, 4) != e->pmotion.windowID) return false;
+    if (bare_sdl__read_record<uint32_t>(previous, 16) != e->pmotion.which) return false;
+
+    bare_sdl__write_record<uint64_t>(previous, 8, e->pmotion.timestamp);
+    bare_sdl__write_record<uint32_t>(previous, 20, e->pmotion.pen_state);
+    bare_sdl__write_record<float>(previous, 24, e->pmotion.x);
+    bare_sdl__write_record<float>(previous, 28, e->pmotion.y);
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+// Mouse state shared with JavaScript as a Float32Array, refreshed whenever
+// events are pumped. SDL resets its relative motion on every query, and
+// events are pumped internally far more often than JavaScript reads the
+// state, so the relative motion is accumulated here and cleared by
+// JavaScript once read. Keep in sync with lib/mouse.js.
+static float bare_sdl__mouse_state[5];
+
+static void
+bare_sdl__refresh_mouse_state() {
+  float x, y, dx, dy;
+
+  SDL_MouseButtonFlags buttons = SDL_GetMouseState(&x, &y);
+
+  SDL_GetRelativeMouseState(&dx, &dy);
+
+  bare_sdl__mouse_state[0] = x;
+  bare_sdl__mouse_state[1] = y;
+  bare_sdl__mouse_state[2] = float(buttons);
+  bare_sdl__mouse_state[3] += dx;
+  bare_sdl__mouse_state[4] += dy;
+}
+
+static void
+bare_sdl__refresh_input_state() {
+  bare_sdl__refresh_mouse_state();
+  bare_sdl__refresh_gamepad_state();
+}
+
+static void
+bare_sdl__pump_events() {
+  SDL_PumpEvents();
+
+  bare_sdl__refresh_input_state();
+}
+
+static js_arraybuffer_t
+bare_sdl_get_keyboard_state(
+  js_env_t *env,
+  js_receiver_t
+) {
+  int err;
+
+  int numkeys;
+  const bool *state = SDL_GetKeyboardState(&numkeys);
+
+  // The array is owned by SDL and stays valid for the lifetime of the
+  // process, so expose it directly rather than copying.
+  js_value_t *handle;
+  err = js_create_external_arraybuffer(env, const_cast<bool *>(state), size_t(numkeys) * sizeof(bool), nullptr, nullptr, &handle);
+  assert(err == 0);
+
+  return js_arraybuffer_t(handle);
+}
+
+static js_arraybuffer_t
+bare_sdl_get_mouse_state(
+  js_env_t *env,
+  js_receiver_t
+) {
+  int err;
+
+  bare_sdl__refresh_mouse_state();
+
+  js_value_t *handle;
+  err = js_create_external_arraybuffer(env, bare_sdl__mouse_state, sizeof(bare_sdl__mouse_state), nullptr, nullptr, &handle);
+  assert(err == 0);
+
+  return js_arraybuffer_t(handle);
+}
+
+static void
+bare_sdl_pump_events(
+  js_env_t *,
+  js_receiver_t
+) {
+  bare_sdl__pump_events();
+}
+
+// Latency histograms count events per category, the upper byte of the event
+// type, in buckets of powers of two microseconds between the event being
+// queued and it being handed to JavaScript. Keep in sync with lib/poller.js.
+#define BARE_SDL_LATENCY_GROUPS  0x81
+#define BARE_SDL_LATENCY_BUCKETS 32
+
+static uint32_t *
+bare_sdl__latency_histogram(js_env_t *env, std::optional<js_arraybuffer_span_t> &buf, uint32_t buf_offset) {
+  int err;
+
+  if (!buf.has_value()) return nullptr;
+
+  if (buf_offset + BARE_SDL_LATENCY_GROUPS * BARE_SDL_LATENCY_BUCKETS * sizeof(uint32_t) > buf->size()) {
+    err = js_throw_range_error(env, nullptr, "Latency buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return reinterpret_cast<uint32_t *>(&(*buf)[buf_offset]);
+}
+
+static void
+bare_sdl__track_latency(uint32_t *histogram, const SDL_Event *e, uint64_t now) {
+  uint32_t group = std::min<uint32_t>(e->type >> 8, BARE_SDL_LATENCY_GROUPS - 1);
+
+  uint64_t us = now > e->common.timestamp ? (now - e->common.timestamp) / SDL_NS_PER_US : 0;
+
+  uint32_t bucket = 0;
+
+  while (us > 0 && bucket < BARE_SDL_LATENCY_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+
+  histogram[group * BARE_SDL_LATENCY_BUCKETS + bucket]++;
+}
+
+static bare_sdl_event_heap_t
+bare_sdl__event_heap(js_env_t *env, js_arraybuffer_span_t &buf, uint32_t buf_offset, uint32_t capacity, uint32_t heap_size) {
+  int err;
+
+  size_t heap_offset = buf_offset + static_cast<size_t>(capacity) * BARE_SDL_EVENT_RECORD_SIZE;
+
+  if (heap_offset + heap_size > buf.size()) {
+    err = js_throw_range_error(env, nullptr, "Event buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return {&buf[heap_offset], heap_size, 0};
+}
+
+static bool
+bare_sdl_poll(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  uint32_t heap_size,
+  std::optional<js_arraybuffer_span_t> latency_buf,
+  uint32_t latency_offset
+) {
+  auto heap = bare_sdl__event_heap(env, buf, buf_offset, 1, heap_size);
+
+  auto histogram = bare_sdl__latency_histogram(env, latency_buf, latency_offset);
+
+  SDL_Event event;
+
+  if (!SDL_PollEvent(&event)) {
+    // The queue has been emptied, which ends a polling loop.
+    bare_sdl__refresh_input_state();
+
+    return false;
+  }
+
+  if (histogram) bare_sdl__track_latency(histogram, &event, SDL_GetTicksNS());
+
+  bare_sdl__encode_event(&event, &buf[buf_offset], &heap);
+
+  return true;
+}
+
+static uint32_t
+bare_sdl_drain(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  uint32_t capacity,
+  uint32_t heap_size,
+  bool coalesce,
+  bool pump,
+  std::optional<js_arraybuffer_span_t> latency_buf,
+  uint32_t latency_offset
+) {
+  auto heap = bare_sdl__event_heap(env, buf, buf_offset, capacity, heap_size);
+
+  auto histogram = bare_sdl__latency_histogram(env, latency_buf, latency_offset);
+
+  // Event watches drain without pumping, as a pump that queues events would
+  // signal the watch again and cause a redundant wakeup.
+  if (pump) bare_sdl__pump_events();
+
+  SDL_Event events[64];
+
+  // The last stored record is kept contiguous so that following motion
+  // events can be coalesced into it before it is stored again.
+  uint8_t record[BARE_SDL_EVENT_RECORD_SIZE];
+
+  uint32_t count = 0;
+
+  while (count < capacity) {
+    int n = SDL_PeepEvents(events, std::min<uint32_t>(capacity - count, 64), SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST);
+
+    if (n <= 0) break;
+
+    uint64_t now = SDL_GetTicksNS();
+
+    for (int i = 0; i < n; i++) {
+      if (histogram) bare_sdl__track_latency(histogram, &events[i], now);
+
+      if (coalesce && count > 0 && bare_sdl__coalesce_event(&events[i], record)) {
+        bare_sdl__store_record(&buf[buf_offset], capacity, count - 1, record);
+        continue;
+      }
+
+      bare_sdl__encode_event(&events[i], record, &heap);
+
+      bare_sdl__store_record(&buf[buf_offset], capacity, count, record);
+
+      count++;
+    }
+  }
+
+  return count;
+}
+
+static void
+bare_sdl_set_event_enabled(
+  js_env_t *,
+  js_receiver_t,
+  uint32_t type,
+  bool enabled
+) {
+  SDL_SetEventEnabled(type, enabled);
+}
+
+static bool
+bare_sdl_get_event_enabled(
+  js_env_t *,
+  js_receiver_t,
+  uint32_t type
+) {
+  return SDL_EventEnabled(type);
+}
+
+static bool SDLCALL
+bare_sdl__on_event_watch(void *userdata, SDL_Event *event) {
+  auto watch = reinterpret_cast<bare_sdl_event_watch_t *>(userdata);
+
+  // Wakeups are coalesced by libuv, so a burst of events results in a single
+  // callback on the loop thread.
+  if (event->type != SDL_EVENT_POLL_SENTINEL) uv_async_send(watch->async);
+
+  return true;
+}
+
+static void
+bare_sdl__on_event_watch_async(uv_async_t *handle) {
+  int err;
+
+  auto watch = reinterpret_cast<bare_sdl_event_watch_t *>(handle->data);
+  auto env = watch->env;
+
+  if (!watch->active) return;
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  bare_sdl_event_watch_callback_t callback;
+  err = js_get_reference_value(env, watch->on_events, callback);
+  assert(err == 0);
+
+  js_call_function(env, callback);
+
+  js_close_handle_scope(env, scope);
+}
+
+static void
+bare_sdl__on_event_watch_pump(uv_timer_t *handle) {
+  // The OS only hands events to SDL when the main thread pumps them, which
+  // then wakes us through the event watch if anything arrived.
+  bare_sdl__pump_events();
+}
+
+static js_arraybuffer_t
+bare_sdl_create_event_watch(
+  js_env_t *env,
+  js_receiver_t,
+  bare_sdl_event_watch_callback_t on_events
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  bare_sdl_event_watch_t *watch;
+  err = js_create_arraybuffer(env, watch, handle);
+  assert(err == 0);
+
+  watch->async = reinterpret_cast<uv_async_t *>(SDL_malloc(sizeof(uv_async_t)));
+  watch->pump = reinterpret_cast<uv_timer_t *>(SDL_malloc(sizeof(uv_timer_t)));
+
+  if (watch->async == nullptr || watch->pump == nullptr) {
+    SDL_free(watch->async);
+    SDL_free(watch->pump);
+
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  watch->env = env;
+
+  err = js_create_reference(env, on_events, watch->on_events);
+  assert(err == 0);
+
+  uv_loop_t *loop;
+  err = js_get_env_loop(env, &loop);
+  assert(err == 0);
+
+  err = uv_async_init(loop, watch->async, bare_sdl__on_event_watch_async);
+  assert(err == 0);
+
+  watch->async->data = watch;
+
+  uv_unref(reinterpret_cast<uv_handle_t *>(watch->async));
+
+  err = uv_timer_init(loop, watch->pump);
+  assert(err == 0);
+
+  watch->pump->data = watch;
+
+  return handle;
+}
+
+static void
+bare_sdl_start_event_watch(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_event_watch_t, 1> watch,
+  uint32_t interval
+) {
+  int err;
+
+  if (watch->active) return;
+
+  if (!SDL_AddEventWatch(bare_sdl__on_event_watch, watch)) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  watch->active = true;
+
+  uv_ref(reinterpret_cast<uv_handle_t *>(watch->async));
+
+  if (interval > 0) {
+    err = uv_timer_start(watch->pump, bare_sdl__on_event_watch_pump, 0, interval);
+    assert(err == 0);
+  }
+
+  // Deliver anything that was queued before the watch was added.
+  if (SDL_HasEvents(SDL_EVENT_FIRST, SDL_EVENT_LAST)) uv_async_send(watch->async);
+}
+
+static void
+bare_sdl_stop_event_watch(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_event_watch_t, 1> watch
+) {
+  if (!watch->active) return;
+
+  watch->active = false;
+
+  SDL_RemoveEventWatch(bare_sdl__on_event_watch, watch);
+
+  uv_timer_stop(watch->pump);
+
+  uv_unref(reinterpret_cast<uv_handle_t *>(watch->async));
+}
+
+static void
+bare_sdl_destroy_event_watch(
+  js_env_t *env,
+  js_receiver_t receiver,
+  js_arraybuffer_span_of_t<bare_sdl_event_watch_t, 1> watch
+) {
+  bare_sdl_stop_event_watch(env, receiver, watch);
+
+  watch->on_events.reset();
+
+  uv_close(reinterpret_cast<uv_handle_t *>(watch->async), bare_sdl__on_handle_close);
+  uv_close(reinterpret_cast<uv_handle_t *>(watch->pump), bare_sdl__on_handle_close);
+}
+
+static void
+on_audio_stream_get(uv_async_t *handle);
+
+static void
+audio_stream_get_callback(void *userdata, SDL_AudioStream *sdl_stream, int needed_bytes, int total_bytes) {
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(userdata);
+
+  uv_mutex_lock(&stream->mutex);
+
+  // Callbacks that fire before the loop gets to deliver the previous one are
+  // coalesced by libuv, so add up what was needed rather than overwriting it.
+  if (stream->get_pending) {
+    stream->get_needed_bytes += needed_bytes;
+    stream->stats.coalesced++;
+  } else {
+    stream->get_needed_bytes = needed_bytes;
+    stream->get_pending = true;
+    stream->get_since = SDL_GetTicksNS();
+  }
+
+  stream->get_total_bytes = total_bytes;
+
+  if (needed_bytes > 0 && needed_bytes == total_bytes) stream->stats.underruns++;
+
+  uv_mutex_unlock(&stream->mutex);
+  uv_async_send(&stream->async_get);
+}
+
+static void
+bare_sdl__audio_stream_delivered(bare_sdl_audio_stream_t *stream, uint64_t since) {
+  uint64_t delay = SDL_GetTicksNS() - since;
+
+  stream->stats.deliveries++;
+  stream->stats.delay_last = delay;
+  stream->stats.delay_total += delay;
+
+  if (delay > stream->stats.delay_max) stream->stats.delay_max = delay;
+}
+
+static void
+on_audio_stream_get(uv_async_t *handle) {
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(handle->data);
+  auto env = stream->env;
+  if (!stream->on_get) {
+    return;
+  }
+
+  js_handle_scope_t *scope;
+  int err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  uv_mutex_lock(&stream->mutex);
+  int needed_bytes = stream->get_needed_bytes;
+  int total_bytes = stream->get_total_bytes;
+  bool pending = stream->get_pending;
+  stream->get_needed_bytes = 0;
+  stream->get_pending = false;
+  if (pending) bare_sdl__audio_stream_delivered(stream, stream->get_since);
+  uv_mutex_unlock(&stream->mutex);
+
+  if (!pending) {
+    js_close_handle_scope(env, scope);
+    return;
+  }
+
+  bare_sdl_audio_stream_get_callback_t callback;
+  err = js_get_reference_value(env, stream->on_get, callback);
+  assert(err == 0);
+
+  js_call_function(env, callback, needed_bytes, total_bytes);
+
+  js_close_handle_scope(env, scope);
+}
+
+static void
+audio_stream_put_callback(void *userdata, SDL_AudioStream *sdl_stream, int added_bytes, int total_bytes) {
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(userdata);
+
+  uv_mutex_lock(&stream->mutex);
+
+  if (stream->put_pending) {
+    stream->put_added_bytes += added_bytes;
+    stream->stats.coalesced++;
+  } else {
+    stream->put_added_bytes = added_bytes;
+    stream->put_pending = true;
+    stream->put_since = SDL_GetTicksNS();
+  }
+
+  stream->put_total_bytes = total_bytes;
+
+  uv_mutex_unlock(&stream->mutex);
+  uv_async_send(&stream->async_put);
+}
+
+static void
+on_audio_stream_put(uv_async_t *handle) {
+  int err;
+
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(handle->data);
+  auto env = stream->env;
+
+  if (!stream->on_put) {
+    return;
+  }
+
+  js_handle_scope_t *scope;
+  err = js_open_handle_scope(env, &scope);
+  assert(err == 0);
+
+  uv_mutex_lock(&stream->mutex);
+  int added_bytes = stream->put_added_bytes;
+  int total_bytes = stream->put_total_bytes;
+  bool pending = stream->put_pending;
+  stream->put_added_bytes = 0;
+  stream->put_pending = false;
+  if (pending) bare_sdl__audio_stream_delivered(stream, stream->put_since);
+  uv_mutex_unlock(&stream->mutex);
+
+  if (!pending) {
+    js_close_handle_scope(env, scope);
+    return;
+  }
+
+  bare_sdl_audio_stream_put_callback_t callback;
+  err = js_get_reference_value(env, stream->on_put, callback);
+  assert(err == 0);
+
+  js_call_function(env, callback, added_bytes, total_bytes);
+  js_close_handle_scope(env, scope);
+}
+
+static js_arraybuffer_t
+bare_sdl_create_audio_stream(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t source_format,
+  int source_channels,
+  int source_freq,
+  uint32_t target_format,
+  int target_channels,
+  int target_freq,
+  std::optional<bare_sdl_audio_stream_get_callback_t> on_get,
+  std::optional<bare_sdl_audio_stream_put_callback_t> on_put
+) {
+  int err;
+  js_arraybuffer_t handle;
+
+  bare_sdl_audio_stream_t *stream;
+  err = js_create_arraybuffer(env, stream, handle);
+  assert(err == 0);
+
+  SDL_AudioSpec source_spec = {static_cast<SDL_AudioFormat>(source_format), source_channels, source_freq};
+  SDL_AudioSpec target_spec = {static_cast<SDL_AudioFormat>(target_format), target_channels, target_freq};
+
+  stream->handle = SDL_CreateAudioStream(&source_spec, &target_spec);
+  if (stream->handle == nullptr) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  stream->env = env;
+
+  uv_mutex_init(&stream->mutex);
+
+  uv_loop_t *loop;
+  err = js_get_env_loop(env, &loop);
+  assert(err == 0);
+
+  if (on_get) {
+    err = js_create_reference(env, *on_get, stream->on_get);
+    assert(err == 0);
+
+    err = uv_async_init(loop, &stream->async_get, on_audio_stream_get);
+    assert(err == 0);
+    stream->async_get.data = stream;
+
+    SDL_SetAudioStreamGetCallback(stream->handle, audio_stream_get_callback, stream);
+  }
+
+  if (on_put) {
+    err = js_create_reference(env, *on_put, stream->on_put);
+    assert(err == 0);
+
+    uv_async_init(loop, &stream->async_put, on_audio_stream_put);
+    stream->async_put.data = stream;
+
+    SDL_SetAudioStreamPutCallback(stream->handle, audio_stream_put_callback, stream);
+  }
+
+  return handle;
+}
+
+static void
+bare_sdl__on_audio_stream_close(uv_handle_t *handle) {
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(handle->data);
+
+  if (--stream->pending_closes == 0) {
+    SDL_DestroyAudioStream(stream->handle);
+    uv_mutex_destroy(&stream->mutex);
+  }
+}
+
+// Audio rings are single-producer/single-consumer byte queues shared between
+// JavaScript and the audio thread. The header holds monotonically increasing
+// read and write positions on separate cache lines, at the given byte offsets,
+// followed by a power of two capacity of data. Keep in sync with
+// lib/audio-stream.js.
+#define BARE_SDL_AUDIO_RING_READ   0
+#define BARE_SDL_AUDIO_RING_WRITE  32
+#define BARE_SDL_AUDIO_RING_HEADER 64
+
+// The capacity is a power of two while frames need not be, so a frame may
+// straddle the end of the ring. SDL only accepts whole frames, so such a frame
+// is passed through a bounce buffer of at most this size.
+#define BARE_SDL_AUDIO_RING_MAX_FRAME 64
+
+// The ring is owned by the ArrayBuffer handed to JavaScript, which may outlive
+// the stream, so it is only freed once that buffer is collected.
+static void
+bare_sdl__on_audio_ring_finalize(js_env_t *env, void *data, void *finalize_hint) {
+  SDL_free(data);
+}
+
+static inline std::atomic_ref<uint32_t>
+bare_sdl__audio_ring_position(uint8_t *ring, size_t offset) {
+  return std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t *>(&ring[offset]));
+}
+
+static void SDLCALL
+bare_sdl__on_audio_ring_get(void *userdata, SDL_AudioStream *sdl_stream, int additional_bytes, int total_bytes) {
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(userdata);
+
+  auto read = bare_sdl__audio_ring_position(stream->ring, BARE_SDL_AUDIO_RING_READ);
+  auto write = bare_sdl__audio_ring_position(stream->ring, BARE_SDL_AUDIO_RING_WRITE);
+
+  uint32_t r = read.load(std::memory_order_relaxed);
+  uint32_t w = write.load(std::memory_order_acquire);
+
+  uint32_t len = std::min<uint32_t>(w - r, uint32_t(std::max(additional_bytes, 0)));
+
+  len -= len % stream->ring_frame_size;
+
+  if (additional_bytes > 0 && additional_bytes == total_bytes && len < uint32_t(additional_bytes)) {
+    std::atomic_ref<uint64_t>(stream->stats.underruns).fetch_add(1, std::memory_order_relaxed);
+  }
+
+  uint8_t *data = &stream->ring[BARE_SDL_AUDIO_RING_HEADER];
+
+  uint32_t frame_size = uint32_t(stream->ring_frame_size);
+
+  uint32_t start = r & (stream->ring_capacity - 1);
+  uint32_t first = std::min(len, stream->ring_capacity - start);
+  uint32_t whole = first - first % frame_size;
+
+  SDL_PutAudioStreamData(sdl_stream, &data[start], int(whole));
+
+  uint32_t rest = 0;
+
+  if (whole < first) {
+    uint8_t frame[BARE_SDL_AUDIO_RING_MAX_FRAME];
+
+    uint32_t tail = first - whole;
+
+    memcpy(frame, &data[start + whole], tail);
+    memcpy(&frame[tail], data, frame_size - tail);
+
+    SDL_PutAudioStreamData(sdl_stream, frame, int(frame_size));
+
+    rest = frame_size - tail;
+  }
+
+  if (first < len) SDL_PutAudioStreamData(sdl_stream, &data[rest], int(len - first - rest));
+
+  read.store(r + len, std::memory_order_release);
+}
+
+static void SDLCALL
+bare_sdl__on_audio_ring_put(void *userdata, SDL_AudioStream *sdl_stream, int additional_bytes, int total_bytes) {
+  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(userdata);
+
+  auto read = bare_sdl__audio_ring_position(stream->ring, BARE_SDL_AUDIO_RING_READ);
+  auto write = bare_sdl__audio_ring_position(stream->ring, BARE_SDL_AUDIO_RING_WRITE);
+
+  uint32_t r = read.load(std::memory_order_acquire);
+  uint32_t w = write.load(std::memory_order_relaxed);
+
+  uint32_t len = std::min<uint32_t>(stream->ring_capacity - (w - r), uint32_t(std::max(SDL_GetAudioStreamAvailable(sdl_stream), 0)));
+
+  len -= len % stream->ring_frame_size;
+
+  uint8_t *data = &stream->ring[BARE_SDL_AUDIO_RING_HEADER];
+
+  uint32_t frame_size = uint32_t(stream->ring_frame_size);
+
+  uint32_t start = w & (stream->ring_capacity - 1);
+  uint32_t first = std::min(len, stream->ring_capacity - start);
+  uint32_t whole = first - first % frame_size;
+
+  int n = SDL_GetAudioStreamData(sdl_stream, &data[start], int(whole));
+
+  uint32_t rest = 0;
+
+  if (n == int(whole) && whole < first) {
+    uint8_t frame[BARE_SDL_AUDIO_RING_MAX_FRAME];
+
+    uint32_t tail = first - whole;
+
+    if (SDL_GetAudioStreamData(sdl_stream, frame, int(frame_size)) == int(frame_size)) {
+      memcpy(&data[start + whole], frame, tail);
+      memcpy(data, &frame[tail], frame_size - tail);
+
+      n += int(frame_size);
+
+      rest = frame_size - tail;
+    }
+  }
+
+  if (n == int(first + rest) && first < len) {
+    int m = SDL_GetAudioStreamData(sdl_stream, &data[rest], int(len - first - rest));
+
+    if (m > 0) n += m;
+  }
+
+  if (n > 0) write.store(w + uint32_t(n), std::memory_order_release);
+
+  // The ring is full, so drop what is left rather than letting the stream
+  // queue grow, and with it the latency, while JavaScript catches up.
+  if (SDL_GetAudioStreamAvailable(sdl_stream) > 0) {
+    SDL_ClearAudioStream(sdl_stream);
+
+    std::atomic_ref<uint64_t>(stream->stats.overruns).fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// Writes the underruns, overruns, coalesced callbacks, and deliveries followed
+// by the last, max, and mean callback delay in milliseconds. Keep in sync with
+// lib/audio-stream.js.
+static void
+bare_sdl_get_audio_stream_stats(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset
+) {
+  int err;
+
+  if (buf_offset + 7 * sizeof(double) > buf.size()) {
+    err = js_throw_range_error(env, nullptr, "Stats buffer too small");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  auto result = reinterpret_cast<double *>(&buf[buf_offset]);
+
+  // Ring callbacks update the counters without the mutex.
+  auto load = [](uint64_t &value) {
+    return double(std::atomic_ref<uint64_t>(value).load(std::memory_order_relaxed));
+  };
+
+  uv_mutex_lock(&stream->mutex);
+
+  auto &stats = stream->stats;
+
+  result[0] = load(stats.underruns);
+  result[1] = load(stats.overruns);
+  result[2] = double(stats.coalesced);
+  result[3] = double(stats.deliveries);
+  result[4] = double(stats.delay_last) / SDL_NS_PER_MS;
+  result[5] = double(stats.delay_max) / SDL_NS_PER_MS;
+  result[6] = stats.deliveries ? double(stats.delay_total) / stats.deliveries / SDL_NS_PER_MS : 0;
+
+  uv_mutex_unlock(&stream->mutex);
+}
+
+static js_arraybuffer_t
+bare_sdl_create_audio_stream_ring(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  uint32_t capacity,
+  bool recording
+) {
+  int err;
+
+  if (stream->ring) {
+    err = js_throw_error(env, nullptr, "Audio stream already has a ring");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0 || capacity > 1u << 30) {
+    err = js_throw_range_error(env, nullptr, "Ring capacity must be a power of two");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  SDL_AudioSpec src_spec, dst_spec;
+
+  if (!SDL_GetAudioStreamFormat(stream->handle, &src_spec, &dst_spec)) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (SDL_AUDIO_FRAMESIZE(recording ? dst_spec : src_spec) > BARE_SDL_AUDIO_RING_MAX_FRAME) {
+    err = js_throw_range_error(env, nullptr, "Audio frames too large for a ring");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  auto ring = static_cast<uint8_t *>(SDL_calloc(1, BARE_SDL_AUDIO_RING_HEADER + capacity));
+
+  if (ring == nullptr) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  stream->ring = ring;
+  stream->ring_capacity = capacity;
+  stream->ring_recording = recording;
+
+  // The ring feeds the input side of a playback stream and drains the output
+  // side of a recording stream.
+  if (recording) {
+    stream->ring_frame_size = SDL_AUDIO_FRAMESIZE(dst_spec);
+
+    SDL_SetAudioStreamPutCallback(stream->handle, bare_sdl__on_audio_ring_put, stream);
+  } else {
+    stream->ring_frame_size = SDL_AUDIO_FRAMESIZE(src_spec);
+
+    SDL_SetAudioStreamGetCallback(stream->handle, bare_sdl__on_audio_ring_get, stream);
+  }
+
+  js_value_t *handle;
+  err = js_create_external_arraybuffer(env, ring, BARE_SDL_AUDIO_RING_HEADER + capacity, bare_sdl__on_audio_ring_finalize, nullptr, &handle);
+  assert(err == 0);
+
+  return js_arraybuffer_t(handle);
+}
+
+static void
+bare_sdl_destroy_audio_stream(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  if (stream->ring) {
+    // Clearing the callbacks waits for the audio thread to leave the ring,
+    // after which only the ArrayBuffer references it.
+    SDL_SetAudioStreamGetCallback(stream->handle, nullptr, nullptr);
+    SDL_SetAudioStreamPutCallback(stream->handle, nullptr, nullptr);
+
+    stream->ring = nullptr;
+  }
+
+  if (stream->on_get) {
+    SDL_SetAudioStreamGetCallback(stream->handle, nullptr, nullptr);
+    stream->on_get.reset();
+    stream->pending_closes++;
+    uv_close(reinterpret_cast<uv_handle_t *>(&stream->async_get), bare_sdl__on_audio_stream_close);
+  }
+
+  if (stream->on_put) {
+    SDL_SetAudioStreamPutCallback(stream->handle, nullptr, nullptr);
+    stream->on_put.reset();
+    stream->pending_closes++;
+    uv_close(reinterpret_cast<uv_handle_t *>(&stream->async_put), bare_sdl__on_audio_stream_close);
+  }
+
+  if (stream->pending_closes == 0) {
+    SDL_DestroyAudioStream(stream->handle);
+    uv_mutex_destroy(&stream->mutex);
+  }
+}
+
+static bool
+bare_sdl_put_audio_stream_data(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int len
+) {
+  bool result = SDL_PutAudioStreamData(stream->handle, &buf[buf_offset], len);
+  return result;
+}
+
+static int
+bare_sdl_get_audio_stream_data(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int len
+) {
+  int result = SDL_GetAudioStreamData(stream->handle, &buf[buf_offset], len);
+  return result;
+}
+
+static int
+bare_sdl_get_audio_stream_available(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_GetAudioStreamAvailable(stream->handle);
+}
+
+static bool
+bare_sdl_flush_audio_stream(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_FlushAudioStream(stream->handle);
+}
+
+static bool
+bare_sdl_clear_audio_stream(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_ClearAudioStream(stream->handle);
+}
+
+static void
+bare_sdl_set_audio_stream_format(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  std::optional<uint32_t> src_format,
+  std::optional<int> src_channels,
+  std::optional<int> src_freq,
+  std::optional<uint32_t> dst_format,
+  std::optional<int> dst_channels,
+  std::optional<int> dst_freq
+) {
+  int err;
+
+  bool set_src = src_format || src_channels || src_freq;
+  bool set_dst = dst_format || dst_channels || dst_freq;
+
+  // The ring callbacks copy whole frames of the format the ring was created
+  // with, which is the output format of a recording ring and the input format
+  // of a playback ring. The other side can change freely.
+  if (stream->ring && (stream->ring_recording ? set_dst : set_src)) {
+    err = js_throw_error(env, nullptr, stream->ring_recording ? "Cannot change the output format of a recording ring" : "Cannot change the input format of a playback ring");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  SDL_AudioSpec src_spec, dst_spec;
+
+  // Fields that are not passed keep their current value.
+  if (!SDL_GetAudioStreamFormat(stream->handle, &src_spec, &dst_spec)) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (set_src) src_spec = {static_cast<SDL_AudioFormat>(src_format.value_or(src_spec.format)), src_channels.value_or(src_spec.channels), src_freq.value_or(src_spec.freq)};
+  if (set_dst) dst_spec = {static_cast<SDL_AudioFormat>(dst_format.value_or(dst_spec.format)), dst_channels.value_or(dst_spec.channels), dst_freq.value_or(dst_spec.freq)};
+
+  if (!SDL_SetAudioStreamFormat(stream->handle, set_src ? &src_spec : nullptr, set_dst ? &dst_spec : nullptr)) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static float
+bare_sdl_get_audio_stream_frequency_ratio(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_GetAudioStreamFrequencyRatio(stream->handle);
+}
+
+static void
+bare_sdl_set_audio_stream_frequency_ratio(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  float ratio
+) {
+  int err;
+
+  if (!SDL_SetAudioStreamFrequencyRatio(stream->handle, ratio)) {
+    err = js_throw_range_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static float
+bare_sdl_get_audio_stream_gain(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_GetAudioStreamGain(stream->handle);
+}
+
+static void
+bare_sdl_set_audio_stream_gain(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  float gain
+) {
+  int err;
+
+  if (!SDL_SetAudioStreamGain(stream->handle, gain)) {
+    err = js_throw_range_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static std::optional<std::vector<int>>
+bare_sdl__get_audio_stream_channel_map(int *chmap, int count) {
+  if (chmap == nullptr) return std::nullopt;
+
+  std::vector<int> result(chmap, chmap + count);
+
+  SDL_free(chmap);
+
+  return result;
+}
+
+static std::optional<std::vector<int>>
+bare_sdl_get_audio_stream_input_channel_map(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  int count;
+  int *chmap = SDL_GetAudioStreamInputChannelMap(stream->handle, &count);
+
+  return bare_sdl__get_audio_stream_channel_map(chmap, count);
+}
+
+static std::optional<std::vector<int>>
+bare_sdl_get_audio_stream_output_channel_map(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  int count;
+  int *chmap = SDL_GetAudioStreamOutputChannelMap(stream->handle, &count);
+
+  return bare_sdl__get_audio_stream_channel_map(chmap, count);
+}
+
+static void
+bare_sdl_set_audio_stream_input_channel_map(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  std::optional<std::vector<int>> chmap
+) {
+  int err;
+
+  bool success = chmap
+                   ? SDL_SetAudioStreamInputChannelMap(stream->handle, chmap->data(), int(chmap->size()))
+                   : SDL_SetAudioStreamInputChannelMap(stream->handle, nullptr, 0);
+
+  if (!success) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static void
+bare_sdl_set_audio_stream_output_channel_map(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
+  std::optional<std::vector<int>> chmap
+) {
+  int err;
+
+  bool success = chmap
+                   ? SDL_SetAudioStreamOutputChannelMap(stream->handle, chmap->data(), int(chmap->size()))
+                   : SDL_SetAudioStreamOutputChannelMap(stream->handle, nullptr, 0);
+
+  if (!success) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+}
+
+static double
+bare_sdl__get_audio_device_latency(SDL_AudioDeviceID device_id) {
+  SDL_AudioSpec spec;
+  int sample_frames;
+
+  if (device_id == 0 || !SDL_GetAudioDeviceFormat(device_id, &spec, &sample_frames)) return 0;
+
+  return sample_frames * 1000.0 / spec.freq;
+}
+
+static double
+bare_sdl_get_audio_stream_latency(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  SDL_AudioSpec src_spec;
+
+  if (!SDL_GetAudioStreamFormat(stream->handle, &src_spec, nullptr)) return 0;
+
+  // Queued data is counted in the input format and drains at the input rate
+  // scaled by the frequency ratio.
+  int queued = SDL_GetAudioStreamQueued(stream->handle);
+  float ratio = SDL_GetAudioStreamFrequencyRatio(stream->handle);
+
+  double latency = 0;
+
+  if (queued > 0 && ratio > 0) {
+    latency = queued / double(SDL_AUDIO_FRAMESIZE(src_spec)) * 1000.0 / (src_spec.freq * ratio);
+  }
+
+  return latency + bare_sdl__get_audio_device_latency(SDL_GetAudioStreamDevice(stream->handle));
+}
+
+static bool
+bare_sdl_bind_audio_stream(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_BindAudioStream(device_id, stream->handle);
+}
+
+static void
+bare_sdl_unbind_audio_stream(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  SDL_UnbindAudioStream(stream->handle);
+}
+
+static uint32_t
+bare_sdl_get_audio_stream_device(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_GetAudioStreamDevice(stream->handle);
+}
+
+static bool
+bare_sdl_audio_stream_device_paused(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_AudioStreamDevicePaused(stream->handle);
+}
+
+static bool
+bare_sdl_pause_audio_stream_device(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_PauseAudioStreamDevice(stream->handle);
+}
+
+static bool
+bare_sdl_resume_audio_stream_device(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+) {
+  return SDL_ResumeAudioStreamDevice(stream->handle);
+}
+
+static uint32_t
+bare_sdl_open_audio_device(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t requested_device_id,
+  std::optional<uint32_t> format,
+  std::optional<int> channels,
+  std::optional<int> freq,
+  std::optional<int> sample_frames
+) {
+  int err;
+
+  SDL_AudioSpec spec;
+  SDL_AudioSpec *spec_ptr = nullptr;
+  if (format.has_value() && channels.has_value() && freq.has_value()) {
+    spec = {
+      .format = static_cast<SDL_AudioFormat>(format.value()),
+      .channels = channels.value(),
+      .freq = freq.value()
+    };
+
+    spec_ptr = &spec;
+  }
+
+  // SDL only reads the buffer size from a hint, so set it for the duration
+  // of the open and then restore whatever was there before. It only applies
+  // if this opens the physical device.
+  std::optional<std::string> previous_sample_frames;
+
+  if (sample_frames) {
+    const char *previous = SDL_GetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES);
+
+    if (previous) previous_sample_frames = previous;
+
+    SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, std::to_string(sample_frames.value()).c_str());
+  }
+
+  auto logical_device_id = SDL_OpenAudioDevice(requested_device_id, spec_ptr);
+
+  if (sample_frames) {
+    if (previous_sample_frames) {
+      SDL_SetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES, previous_sample_frames->c_str());
+    } else {
+      SDL_ResetHint(SDL_HINT_AUDIO_DEVICE_SAMPLE_FRAMES);
+    }
+  }
+
+  if (logical_device_id == 0) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return logical_device_id;
+}
+
+static double
+bare_sdl_get_audio_device_latency(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  return bare_sdl__get_audio_device_latency(device_id);
+}
+
+static void
+bare_sdl_close_audio_device(
+  js_env_t *,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  SDL_CloseAudioDevice(device_id);
+}
+
+static bool
+bare_sdl_pause_audio_device(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  return SDL_PauseAudioDevice(device_id);
+}
+
+static bool
+bare_sdl_resume_audio_device(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  return SDL_ResumeAudioDevice(device_id);
+}
+
+static std::vector<uint32_t>
+bare_sdl_get_audio_playback_devices(
+  js_env_t *env,
+  js_receiver_t
+) {
+  int count = 0;
+  SDL_AudioDeviceID *devices = SDL_GetAudioPlaybackDevices(&count);
+
+  std::vector<uint32_t> list;
+
+  if (devices != nullptr) {
+    for (int i = 0; i < count; i++) {
+      list.push_back(devices[i]);
+    }
+    SDL_free(devices);
+  }
+
+  return list;
+}
+
+static std::vector<uint32_t>
+bare_sdl_get_audio_recording_devices(
+  js_env_t *env,
+  js_receiver_t
+) {
+  int count = 0;
+  SDL_AudioDeviceID *devices = SDL_GetAudioRecordingDevices(&count);
+
+  std::vector<uint32_t> list;
+
+  if (devices != nullptr) {
+    for (int i = 0; i < count; i++) {
+      list.push_back(devices[i]);
+    }
+    SDL_free(devices);
+  }
+
+  return list;
+}
+
+static std::optional<uint32_t>
+bare_sdl_get_audio_device_list_item(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_device_list_t, 1> list,
+  int index
+) {
+  if (index < 0 || index >= list->count || !list->devices) {
+    return std::nullopt;
+  }
+
+  return list->devices[index];
+}
+
+static std::optional<std::string>
+bare_sdl_get_audio_device_name(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  const char *name = SDL_GetAudioDeviceName(device_id);
+  return name ? std::optional<std::string>(name) : std::nullopt;
+}
+
+static double
+bare_sdl_get_audio_device_gain(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  return SDL_GetAudioDeviceGain(device_id);
+}
+
+static void
+bare_sdl_set_audio_device_gain(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id,
+  double gain
+) {
+  SDL_SetAudioDeviceGain(device_id, static_cast<float>(gain));
+}
+
+static js_arraybuffer_t
+bare_sdl_get_audio_device_format(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t device_id
+) {
+  int err;
+
+  js_arraybuffer_t handle;
+
+  bare_sdl_audio_device_format_t *format;
+  err = js_create_arraybuffer(env, format, handle);
+  assert(err == 0);
+
+  format->valid = SDL_GetAudioDeviceFormat(
+    device_id,
+    &format->spec,
+    &format->sample_frames
+  );
+
+  return handle;
+}
+
+static bool
+bare_sdl_get_audio_device_format_valid(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+) {
+  return format->valid;
+}
+
+static uint32_t
+bare_sdl_get_audio_device_format_format(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+) {
+  return format->spec.format;
+}
+
+static int
+bare_sdl_get_audio_device_format_channels(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+) {
+  return format->spec.channels;
+}
+
+static int
+bare_sdl_get_audio_device_format_freq(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+) {
+  return format->spec.freq;
+}
+
+static int
+bare_sdl_get_audio_device_format_sample_frames(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+) {
+  return format->sample_frames;
+}
+
+static bool
+bare_sdl_is_audio_device_physical(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t deviceId
 ) {
-  r->handle.x = x;
-  r->handle.y = y;
-  r->handle.w = w;
-  r->handle.h = h;
+  return SDL_IsAudioDevicePhysical(deviceId);
 }
 
-static int
-bare_sdl_get_rect_x(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
-  return r->handle.x;
+static bool
+bare_sdl_is_audio_device_playback(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t deviceId
+) {
+  return SDL_IsAudioDevicePlayback(deviceId);
 }
 
-static int
-bare_sdl_get_rect_y(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
-  return r->handle.y;
+static bool
+bare_sdl_is_audio_device_paused(
+  js_env_t *env,
+  js_receiver_t,
+  uint32_t deviceId
+) {
+  return SDL_AudioDevicePaused(deviceId);
 }
 
-static int
-bare_sdl_get_rect_w(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
-  return r->handle.w;
-}
+// Audio mixer
 
-static int
-bare_sdl_get_rect_h(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_rect_t, 1> r) {
-  return r->handle.h;
-}
+static void SDLCALL
+bare_sdl__on_audio_mixer_get(void *userdata, SDL_AudioStream *output, int additional_bytes, int total_bytes) {
+  auto mixer = reinterpret_cast<bare_sdl_audio_mixer_t *>(userdata);
 
-// FRect
+  int channels = mixer->channels;
+
+  // The output stream is locked while its callback runs, which also guards
+  // the source table against changes from JavaScript.
+  while (additional_bytes > 0) {
+    int frames = std::min<int>(additional_bytes / int(sizeof(float)), BARE_SDL_AUDIO_MIXER_SAMPLES) / channels;
+
+    if (frames <= 0) break;
+
+    int samples = frames * channels;
+    int bytes = samples * int(sizeof(float));
+
+    float *mix = mixer->mix;
+    float *scratch = mixer->scratch;
+
+    memset(mix, 0, bytes);
+
+    for (int i = 0; i < BARE_SDL_AUDIO_MIXER_SOURCES; i++) {
+      auto &source = mixer->sources[i];
+
+      if (source.stream == nullptr) continue;
+
+      int n = SDL_GetAudioStreamData(source.stream, scratch, bytes);
+
+      if (n <= 0) continue;
+
+      n /= int(sizeof(float));
+
+      float gain = std::atomic_ref<float>(source.gain).load(std::memory_order_relaxed);
+
+      if (channels == 2) {
+        // Constant power panning keeps the perceived loudness steady across
+        // the stereo field.
+        float angle = (std::atomic_ref<float>(source.pan).load(std::memory_order_relaxed) + 1) * SDL_PI_F / 4;
+
+        float left = gain * SDL_cosf(angle) * SDL_sqrtf(2.0f);
+        float right = gain * SDL_sinf(angle) * SDL_sqrtf(2.0f);
+
+        for (int j = 0; j + 1 < n; j += 2) {
+          mix[j] += scratch[j] * left;
+          mix[j + 1] += scratch[j + 1] * right;
+        }
+      } else {
+        for (int j = 0; j < n; j++) {
+          mix[j] += scratch[j] * gain;
+        }
+      }
+    }
+
+    SDL_PutAudioStreamData(output, mix, bytes);
+
+    additional_bytes -= bytes;
+  }
+}
 
 static js_arraybuffer_t
-bare_sdl_create_frect(
+bare_sdl_create_audio_mixer(
   js_env_t *env,
   js_receiver_t,
-  double x,
-  double y,
-  double w,
-  double h
+  int channels,
+  int freq
 ) {
+  int err;
+
+  if (channels < 1 || channels > 8) {
+    err = js_throw_range_error(env, nullptr, "Mixer channels must be between 1 and 8");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
   js_arraybuffer_t handle;
 
-  bare_sdl_frect_t *r;
-  int err = js_create_arraybuffer(env, r, handle);
+  bare_sdl_audio_mixer_t *mixer;
+  err = js_create_arraybuffer(env, mixer, handle);
   assert(err == 0);
 
-  r->handle.x = static_cast<float>(x);
-  r->handle.y = static_cast<float>(y);
-  r->handle.w = static_cast<float>(w);
-  r->handle.h = static_cast<float>(h);
+  mixer->channels = channels;
+  mixer->freq = freq;
+
+  SDL_AudioSpec spec = {SDL_AUDIO_F32, channels, freq};
+
+  mixer->output = SDL_CreateAudioStream(&spec, &spec);
+
+  if (mixer->output == nullptr) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  SDL_SetAudioStreamGetCallback(mixer->output, bare_sdl__on_audio_mixer_get, mixer);
 
   return handle;
 }
 
 static void
-bare_sdl_set_frect(
+bare_sdl_destroy_audio_mixer(
   js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r,
-  double x,
-  double y,
-  double w,
-  double h
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer
 ) {
-  r->handle.x = static_cast<float>(x);
-  r->handle.y = static_cast<float>(y);
-  r->handle.w = static_cast<float>(w);
-  r->handle.h = static_cast<float>(h);
-}
+  SDL_DestroyAudioStream(mixer->output);
 
-static double
-bare_sdl_get_frect_x(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
-  return r->handle.x;
+  for (auto &source : mixer->sources) {
+    if (source.stream) SDL_DestroyAudioStream(source.stream);
+  }
 }
 
-static double
-bare_sdl_get_frect_y(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
-  return r->handle.y;
-}
+static int
+bare_sdl_add_audio_mixer_source(
+  js_env_t *env,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t format,
+  int channels,
+  int freq,
+  float gain,
+  float pan
+) {
+  int err;
 
-static double
-bare_sdl_get_frect_w(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
-  return r->handle.w;
-}
+  SDL_AudioSpec source_spec = {static_cast<SDL_AudioFormat>(format), channels, freq};
+  SDL_AudioSpec target_spec = {SDL_AUDIO_F32, mixer->channels, mixer->freq};
 
-static double
-bare_sdl_get_frect_h(js_env_t *, js_receiver_t, js_arraybuffer_span_of_t<bare_sdl_frect_t, 1> r) {
-  return r->handle.h;
+  SDL_AudioStream *stream = SDL_CreateAudioStream(&source_spec, &target_spec);
+
+  if (stream == nullptr) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  SDL_LockAudioStream(mixer->output);
+
+  int index = -1;
+
+  for (int i = 0; i < BARE_SDL_AUDIO_MIXER_SOURCES; i++) {
+    auto &source = mixer->sources[i];
+
+    if (source.stream) continue;
+
+    source.stream = stream;
+    source.gain = gain;
+    source.pan = std::clamp(pan, -1.0f, 1.0f);
+
+    index = i;
+    break;
+  }
+
+  SDL_UnlockAudioStream(mixer->output);
+
+  if (index == -1) {
+    SDL_DestroyAudioStream(stream);
+
+    err = js_throw_errorf(env, nullptr, "Mixer supports at most %d sources", BARE_SDL_AUDIO_MIXER_SOURCES);
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  return index;
 }
 
-// Events
+static void
+bare_sdl_remove_audio_mixer_source(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t index
+) {
+  if (index >= BARE_SDL_AUDIO_MIXER_SOURCES) return;
+
+  SDL_LockAudioStream(mixer->output);
+
+  SDL_AudioStream *stream = mixer->sources[index].stream;
+
+  mixer->sources[index].stream = nullptr;
+
+  SDL_UnlockAudioStream(mixer->output);
+
+  if (stream) SDL_DestroyAudioStream(stream);
+}
 
 static bool
-bare_sdl_poll(
+bare_sdl_put_audio_mixer_source_data(
   js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_event_t, 1> e
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t index,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int len
 ) {
-  return SDL_PollEvent(&e->handle);
+  if (index >= BARE_SDL_AUDIO_MIXER_SOURCES || mixer->sources[index].stream == nullptr) return false;
+
+  return SDL_PutAudioStreamData(mixer->sources[index].stream, &buf[buf_offset], len);
 }
 
-static js_arraybuffer_t
-bare_sdl_create_event(
-  js_env_t *env,
-  js_receiver_t
+static int
+bare_sdl_get_audio_mixer_source_available(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t index
 ) {
-  int err;
+  if (index >= BARE_SDL_AUDIO_MIXER_SOURCES || mixer->sources[index].stream == nullptr) return 0;
 
-  js_arraybuffer_t handle;
+  return SDL_GetAudioStreamQueued(mixer->sources[index].stream);
+}
 
-  bare_sdl_event_t *event;
-  err = js_create_arraybuffer(env, event, handle);
-  assert(err == 0);
+static void
+bare_sdl_set_audio_mixer_source_gain(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t index,
+  float gain
+) {
+  if (index >= BARE_SDL_AUDIO_MIXER_SOURCES) return;
 
-  return handle;
+  std::atomic_ref<float>(mixer->sources[index].gain).store(gain, std::memory_order_relaxed);
 }
 
-static uint32_t
-bare_sdl_get_event_type(
-  js_env_t *env,
+static void
+bare_sdl_set_audio_mixer_source_pan(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_event_t, 1> e
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t index,
+  float pan
 ) {
-  return e->handle.type;
+  if (index >= BARE_SDL_AUDIO_MIXER_SOURCES) return;
+
+  std::atomic_ref<float>(mixer->sources[index].pan).store(std::clamp(pan, -1.0f, 1.0f), std::memory_order_relaxed);
 }
 
-static js_arraybuffer_t
-bare_sdl_get_event_key(
-  js_env_t *env,
+static bool
+bare_sdl_bind_audio_mixer(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_event_t, 1> e
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  uint32_t device_id
 ) {
-  int err;
+  return SDL_BindAudioStream(device_id, mixer->output);
+}
 
-  js_arraybuffer_t handle;
+static void
+bare_sdl_unbind_audio_mixer(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer
+) {
+  SDL_UnbindAudioStream(mixer->output);
+}
 
-  bare_sdl_keyboard_event_t *key;
-  err = js_create_arraybuffer(env, key, handle);
-  assert(err == 0);
+static int
+bare_sdl_get_audio_mixer_data(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_mixer_t, 1> mixer,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int len
+) {
+  return SDL_GetAudioStreamData(mixer->output, &buf[buf_offset], len);
+}
 
-  key->handle = e->handle.key;
+// Audio file
 
-  return handle;
+static bool
+bare_sdl__read_wav_header(SDL_IOStream *io, SDL_AudioSpec *spec, Sint64 *data_start, Sint64 *data_size) {
+  Uint32 riff, size, wave;
+
+  if (!SDL_ReadU32LE(io, &riff) || !SDL_ReadU32LE(io, &size) || !SDL_ReadU32LE(io, &wave)) {
+    return SDL_SetError("Not a WAV file");
+  }
+
+  if (riff != 0x46464952 /* RIFF */ || wave != 0x45564157 /* WAVE */) {
+    return SDL_SetError("Not a WAV file");
+  }
+
+  bool has_format = false;
+
+  while (true) {
+    Uint32 id, len;
+
+    if (!SDL_ReadU32LE(io, &id) || !SDL_ReadU32LE(io, &len)) {
+      return SDL_SetError("WAV file has no data chunk");
+    }
+
+    Sint64 start = SDL_TellIO(io);
+
+    if (id == 0x20746d66 /* fmt */) {
+      Uint16 tag, channels, block_align, bits;
+      Uint32 freq, byte_rate;
+
+      if (len < 16 || !SDL_ReadU16LE(io, &tag) || !SDL_ReadU16LE(io, &channels) || !SDL_ReadU32LE(io, &freq) || !SDL_ReadU32LE(io, &byte_rate) || !SDL_ReadU16LE(io, &block_align) || !SDL_ReadU16LE(io, &bits)) {
+        return SDL_SetError("Invalid WAV format chunk");
+      }
+
+      // WAVE_FORMAT_EXTENSIBLE stores the actual encoding at the start of the
+      // sub-format GUID.
+      if (tag == 0xfffe) {
+        Uint16 extra, valid_bits;
+        Uint32 channel_mask;
+
+        if (len < 26 || !SDL_ReadU16LE(io, &extra) || !SDL_ReadU16LE(io, &valid_bits) || !SDL_ReadU32LE(io, &channel_mask) || !SDL_ReadU16LE(io, &tag)) {
+          return SDL_SetError("Invalid WAV format chunk");
+        }
+      }
+
+      SDL_AudioFormat format;
+
+      if (tag == 1 && bits == 8) format = SDL_AUDIO_U8;
+      else if (tag == 1 && bits == 16) format = SDL_AUDIO_S16LE;
+      else if (tag == 1 && bits == 32) format = SDL_AUDIO_S32LE;
+      else if (tag == 3 && bits == 32) format = SDL_AUDIO_F32LE;
+      else return SDL_SetError("Unsupported WAV encoding %d with %d bits per sample", tag, bits);
+
+      if (channels == 0 || freq == 0) {
+        return SDL_SetError("Invalid WAV format chunk");
+      }
+
+      spec->format = format;
+      spec->channels = channels;
+      spec->freq = int(freq);
+
+      has_format = true;
+    } else if (id == 0x61746164 /* data */) {
+      if (!has_format) {
+        return SDL_SetError("WAV data chunk precedes format chunk");
+      }
+
+      *data_start = start;
+      *data_size = len;
+
+      // Streaming writers may leave the data size unset, so trust the file
+      // size whenever the two disagree.
+      Sint64 remaining = SDL_GetIOSize(io) - start;
+
+      if (remaining >= 0 && (len == 0 || len > remaining)) *data_size = remaining;
+
+      return true;
+    }
+
+    if (SDL_SeekIO(io, start + len + (len & 1), SDL_IO_SEEK_SET) < 0) return false;
+  }
 }
 
-static uint32_t
-bare_sdl_get_event_key_scancode(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_keyboard_event_t, 1> key
-) {
-  return key->handle.scancode;
+static inline std::atomic_ref<uint64_t>
+bare_sdl__audio_file_ring_position(uint64_t &position) {
+  return std::atomic_ref<uint64_t>(position);
 }
 
+// Reads from the file into the ring until either is exhausted. Must be called
+// with the mutex held, and may block on file I/O, so never from the audio
+// thread.
 static void
-on_audio_stream_get(uv_async_t *handle);
+bare_sdl__fill_audio_file(bare_sdl_audio_file_t *file) {
+  auto read = bare_sdl__audio_file_ring_position(file->ring_read);
+  auto write = bare_sdl__audio_file_ring_position(file->ring_write);
 
-static void
-audio_stream_get_callback(void *userdata, SDL_AudioStream *sdl_stream, int needed_bytes, int total_bytes) {
-  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(userdata);
+  while (!file->eof) {
+    Sint64 remaining = file->data_size - file->read;
 
-  uv_mutex_lock(&stream->mutex);
-  stream->get_needed_bytes = needed_bytes;
-  stream->get_total_bytes = total_bytes;
-  uv_mutex_unlock(&stream->mutex);
-  uv_async_send(&stream->async_get);
+    if (remaining <= 0) {
+      if (file->loop && file->data_size > 0 && SDL_SeekIO(file->io, file->data_start, SDL_IO_SEEK_SET) >= 0) {
+        file->read = 0;
+        continue;
+      }
+
+      std::atomic_ref<bool>(file->eof).store(true, std::memory_order_release);
+      break;
+    }
+
+    uint64_t r = read.load(std::memory_order_acquire);
+    uint64_t w = write.load(std::memory_order_relaxed);
+
+    // The capacity is a whole number of frames, so a frame never straddles
+    // the end of the ring.
+    uint64_t start = w % file->ring_capacity;
+    uint64_t len = std::min<uint64_t>(file->ring_capacity - (w - r), file->ring_capacity - start);
+
+    len = std::min<uint64_t>(len, uint64_t(remaining));
+    len -= len % file->frame_size;
+
+    if (len == 0) break;
+
+    len = SDL_ReadIO(file->io, &file->ring[start], len);
+
+    len -= len % file->frame_size;
+
+    if (len == 0) {
+      std::atomic_ref<bool>(file->eof).store(true, std::memory_order_release);
+      break;
+    }
+
+    file->read += len;
+
+    write.store(w + len, std::memory_order_release);
+  }
 }
 
 static void
-on_audio_stream_get(uv_async_t *handle) {
-  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(handle->data);
-  auto env = stream->env;
-  if (!stream->on_get) {
-    return;
+bare_sdl__on_audio_file_thread(void *data) {
+  auto file = reinterpret_cast<bare_sdl_audio_file_t *>(data);
+
+  uv_mutex_lock(&file->mutex);
+
+  while (!file->stopping) {
+    bare_sdl__fill_audio_file(file);
+
+    uv_mutex_unlock(&file->mutex);
+
+    uv_sem_wait(&file->wake);
+
+    uv_mutex_lock(&file->mutex);
   }
 
-  js_handle_scope_t *scope;
-  int err = js_open_handle_scope(env, &scope);
-  assert(err == 0);
+  uv_mutex_unlock(&file->mutex);
+}
+
+static void SDLCALL
+bare_sdl__on_audio_file_get(void *userdata, SDL_AudioStream *stream, int additional_bytes, int total_bytes) {
+  auto file = reinterpret_cast<bare_sdl_audio_file_t *>(userdata);
+
+  auto read = bare_sdl__audio_file_ring_position(file->ring_read);
+  auto write = bare_sdl__audio_file_ring_position(file->ring_write);
+
+  bool consumed = false;
 
-  uv_mutex_lock(&stream->mutex);
-  int needed_bytes = stream->get_needed_bytes;
-  int total_bytes = stream->get_total_bytes;
-  uv_mutex_unlock(&stream->mutex);
+  // Only the ring is touched here, so the audio thread never waits on the
+  // file. If the reader falls behind, the device plays silence until it
+  // catches up.
+  while (!file->ended && SDL_GetAudioStreamAvailable(stream) < total_bytes) {
+    // Check for the end before loading the write counter, so that data
+    // written just before the reader reached the end is not skipped.
+    bool eof = std::atomic_ref<bool>(file->eof).load(std::memory_order_acquire);
 
-  bare_sdl_audio_stream_get_callback_t callback;
-  err = js_get_reference_value(env, stream->on_get, callback);
-  assert(err == 0);
+    uint64_t r = read.load(std::memory_order_relaxed);
+    uint64_t w = write.load(std::memory_order_acquire);
 
-  js_call_function(env, callback, needed_bytes, total_bytes);
+    uint64_t start = r % file->ring_capacity;
+    uint64_t len = std::min<uint64_t>(w - r, file->ring_capacity - start);
 
-  js_close_handle_scope(env, scope);
-}
+    len = std::min<uint64_t>(len, BARE_SDL_AUDIO_FILE_CHUNK);
+    len -= len % file->frame_size;
 
-static void
-audio_stream_put_callback(void *userdata, SDL_AudioStream *sdl_stream, int added_bytes, int total_bytes) {
-  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(userdata);
-  uv_mutex_lock(&stream->mutex);
-  stream->put_added_bytes = added_bytes;
-  stream->put_total_bytes = total_bytes;
-  uv_mutex_unlock(&stream->mutex);
-  uv_async_send(&stream->async_put);
-}
+    if (len > 0) {
+      SDL_PutAudioStreamData(stream, &file->ring[start], int(len));
 
-static void
-on_audio_stream_put(uv_async_t *handle) {
-  int err;
+      read.store(r + len, std::memory_order_release);
 
-  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(handle->data);
-  auto env = stream->env;
+      file->position += len;
 
-  if (!stream->on_put) {
-    return;
-  }
+      // The ring may hold data from after a wrap even once looping stops.
+      if (file->position > file->data_size || (file->position == file->data_size && file->loop)) {
+        file->position -= file->data_size;
+      }
 
-  js_handle_scope_t *scope;
-  err = js_open_handle_scope(env, &scope);
-  assert(err == 0);
+      consumed = true;
+    }
 
-  uv_mutex_lock(&stream->mutex);
-  int added_bytes = stream->put_added_bytes;
-  int total_bytes = stream->put_total_bytes;
-  uv_mutex_unlock(&stream->mutex);
+    if (eof && r + len == w) {
+      file->ended = true;
+      SDL_FlushAudioStream(stream);
+      break;
+    }
 
-  bare_sdl_audio_stream_put_callback_t callback;
-  err = js_get_reference_value(env, stream->on_put, callback);
-  assert(err == 0);
+    if (len == 0) break;
+  }
 
-  js_call_function(env, callback, added_bytes, total_bytes);
-  js_close_handle_scope(env, scope);
+  if (consumed) uv_sem_post(&file->wake);
+}
+
+static bool
+bare_sdl__is_audio_format(SDL_AudioFormat format) {
+  switch (format) {
+  case SDL_AUDIO_U8:
+  case SDL_AUDIO_S8:
+  case SDL_AUDIO_S16LE:
+  case SDL_AUDIO_S16BE:
+  case SDL_AUDIO_S32LE:
+  case SDL_AUDIO_S32BE:
+  case SDL_AUDIO_F32LE:
+  case SDL_AUDIO_F32BE:
+    return true;
+  default:
+    return false;
+  }
 }
 
 static js_arraybuffer_t
-bare_sdl_create_audio_stream(
+bare_sdl_open_audio_file(
   js_env_t *env,
   js_receiver_t,
-  uint32_t source_format,
-  int source_channels,
-  int source_freq,
-  uint32_t target_format,
-  int target_channels,
-  int target_freq,
-  std::optional<bare_sdl_audio_stream_get_callback_t> on_get,
-  std::optional<bare_sdl_audio_stream_put_callback_t> on_put
+  std::string path,
+  std::optional<uint32_t> format,
+  std::optional<int> channels,
+  std::optional<int> freq
 ) {
   int err;
+
+  SDL_AudioSpec raw_spec;
+
+  if (format) {
+    raw_spec = {static_cast<SDL_AudioFormat>(format.value()), channels.value_or(2), freq.value_or(48000)};
+
+    if (!bare_sdl__is_audio_format(raw_spec.format) || raw_spec.channels <= 0 || raw_spec.freq <= 0) {
+      err = js_throw_error(env, nullptr, "Invalid audio spec");
+      assert(err == 0);
+
+      throw js_pending_exception;
+    }
+  }
+
   js_arraybuffer_t handle;
 
-  bare_sdl_audio_stream_t *stream;
-  err = js_create_arraybuffer(env, stream, handle);
+  bare_sdl_audio_file_t *file;
+  err = js_create_arraybuffer(env, file, handle);
   assert(err == 0);
 
-  SDL_AudioSpec source_spec = {static_cast<SDL_AudioFormat>(source_format), source_channels, source_freq};
-  SDL_AudioSpec target_spec = {static_cast<SDL_AudioFormat>(target_format), target_channels, target_freq};
+  file->io = SDL_IOFromFile(path.c_str(), "rb");
 
-  stream->handle = SDL_CreateAudioStream(&source_spec, &target_spec);
-  if (stream->handle == nullptr) {
+  if (file->io == nullptr) {
     err = js_throw_error(env, nullptr, SDL_GetError());
     assert(err == 0);
 
     throw js_pending_exception;
   }
 
-  stream->env = env;
+  bool success;
 
-  uv_mutex_init(&stream->mutex);
+  if (format) {
+    // Raw PCM in the given format, with no header.
+    file->spec = raw_spec;
+    file->data_start = 0;
+    file->data_size = SDL_GetIOSize(file->io);
 
-  uv_loop_t *loop;
-  err = js_get_env_loop(env, &loop);
-  assert(err == 0);
+    success = file->data_size >= 0;
+  } else {
+    success = bare_sdl__read_wav_header(file->io, &file->spec, &file->data_start, &file->data_size);
+  }
 
-  if (on_get) {
-    err = js_create_reference(env, *on_get, stream->on_get);
-    assert(err == 0);
+  if (success) {
+    file->frame_size = SDL_AUDIO_FRAMESIZE(file->spec);
+    file->data_size -= file->data_size % file->frame_size;
 
-    err = uv_async_init(loop, &stream->async_get, on_audio_stream_get);
-    assert(err == 0);
-    stream->async_get.data = stream;
+    success = SDL_SeekIO(file->io, file->data_start, SDL_IO_SEEK_SET) >= 0;
+  }
 
-    SDL_SetAudioStreamGetCallback(stream->handle, audio_stream_get_callback, stream);
+  if (success) {
+    file->ring_capacity = BARE_SDL_AUDIO_FILE_RING - BARE_SDL_AUDIO_FILE_RING % file->frame_size;
+    file->ring = static_cast<uint8_t *>(SDL_malloc(file->ring_capacity));
+
+    success = file->ring != nullptr;
   }
 
-  if (on_put) {
-    err = js_create_reference(env, *on_put, stream->on_put);
+  if (success) {
+    file->stream = SDL_CreateAudioStream(&file->spec, &file->spec);
+
+    success = file->stream != nullptr;
+  }
+
+  if (!success) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
     assert(err == 0);
 
-    uv_async_init(loop, &stream->async_put, on_audio_stream_put);
-    stream->async_put.data = stream;
+    SDL_free(file->ring);
+    SDL_CloseIO(file->io);
 
-    SDL_SetAudioStreamPutCallback(stream->handle, audio_stream_put_callback, stream);
+    throw js_pending_exception;
   }
 
-  return handle;
-}
+  err = uv_mutex_init(&file->mutex);
+  assert(err == 0);
 
-static void
-bare_sdl__on_audio_stream_close(uv_handle_t *handle) {
-  auto stream = reinterpret_cast<bare_sdl_audio_stream_t *>(handle->data);
+  err = uv_sem_init(&file->wake, 0);
+  assert(err == 0);
 
-  if (--stream->pending_closes == 0) {
-    SDL_DestroyAudioStream(stream->handle);
-    uv_mutex_destroy(&stream->mutex);
-  }
+  err = uv_thread_create(&file->thread, bare_sdl__on_audio_file_thread, file);
+  assert(err == 0);
+
+  SDL_SetAudioStreamGetCallback(file->stream, bare_sdl__on_audio_file_get, file);
+
+  return handle;
 }
 
 static void
-bare_sdl_destroy_audio_stream(
-  js_env_t *env,
+bare_sdl_close_audio_file(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
+  int err;
 
-  if (stream->on_get) {
-    SDL_SetAudioStreamGetCallback(stream->handle, nullptr, nullptr);
-    stream->on_get.reset();
-    stream->pending_closes++;
-    uv_close(reinterpret_cast<uv_handle_t *>(&stream->async_get), bare_sdl__on_audio_stream_close);
-  }
+  // Destroying the stream waits for the audio thread to leave the callback.
+  SDL_DestroyAudioStream(file->stream);
 
-  if (stream->on_put) {
-    SDL_SetAudioStreamPutCallback(stream->handle, nullptr, nullptr);
-    stream->on_put.reset();
-    stream->pending_closes++;
-    uv_close(reinterpret_cast<uv_handle_t *>(&stream->async_put), bare_sdl__on_audio_stream_close);
-  }
+  uv_mutex_lock(&file->mutex);
+
+  file->stopping = true;
+
+  uv_mutex_unlock(&file->mutex);
+
+  uv_sem_post(&file->wake);
+
+  err = uv_thread_join(&file->thread);
+  assert(err == 0);
+
+  uv_sem_destroy(&file->wake);
+  uv_mutex_destroy(&file->mutex);
+
+  SDL_free(file->ring);
+  SDL_CloseIO(file->io);
 }
 
-static bool
-bare_sdl_put_audio_stream_data(
-  js_env_t *env,
+static uint32_t
+bare_sdl_get_audio_file_format(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
-  js_arraybuffer_span_t buf,
-  uint32_t buf_offset,
-  int len
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  bool result = SDL_PutAudioStreamData(stream->handle, &buf[buf_offset], len);
-  return result;
+  return file->spec.format;
 }
 
 static int
-bare_sdl_get_audio_stream_data(
-  js_env_t *env,
+bare_sdl_get_audio_file_channels(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream,
-  js_arraybuffer_span_t buf,
-  uint32_t buf_offset,
-  int len
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  int result = SDL_GetAudioStreamData(stream->handle, &buf[buf_offset], len);
-  return result;
+  return file->spec.channels;
 }
 
 static int
-bare_sdl_get_audio_stream_available(
-  js_env_t *env,
+bare_sdl_get_audio_file_freq(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  return SDL_GetAudioStreamAvailable(stream->handle);
+  return file->spec.freq;
 }
 
-static bool
-bare_sdl_flush_audio_stream(
-  js_env_t *env,
+static int64_t
+bare_sdl_get_audio_file_frames(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  return SDL_FlushAudioStream(stream->handle);
+  return file->data_size / file->frame_size;
 }
 
-static bool
-bare_sdl_clear_audio_stream(
-  js_env_t *env,
+static int64_t
+bare_sdl_get_audio_file_position(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  return SDL_ClearAudioStream(stream->handle);
-}
+  SDL_LockAudioStream(file->stream);
 
-static bool
-bare_sdl_bind_audio_stream(
-  js_env_t *env,
-  js_receiver_t,
-  uint32_t device_id,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
-) {
-  return SDL_BindAudioStream(device_id, stream->handle);
-}
+  // Data still queued in the stream has been taken from the ring but not yet
+  // played, so it does not count towards the position.
+  Sint64 position = file->position - SDL_GetAudioStreamQueued(file->stream);
 
-static void
-bare_sdl_unbind_audio_stream(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
-) {
-  SDL_UnbindAudioStream(stream->handle);
-}
+  if (position < 0) position += file->data_size;
 
-static uint32_t
-bare_sdl_get_audio_stream_device(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
-) {
-  return SDL_GetAudioStreamDevice(stream->handle);
-}
+  SDL_UnlockAudioStream(file->stream);
 
-static bool
-bare_sdl_audio_stream_device_paused(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
-) {
-  return SDL_AudioStreamDevicePaused(stream->handle);
+  return std::max<Sint64>(position, 0) / file->frame_size;
 }
 
 static bool
-bare_sdl_pause_audio_stream_device(
-  js_env_t *env,
+bare_sdl_seek_audio_file(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file,
+  int64_t frame
 ) {
-  return SDL_PauseAudioStreamDevice(stream->handle);
-}
+  Sint64 offset = std::clamp<Sint64>(frame, 0, file->data_size / file->frame_size) * file->frame_size;
 
-static bool
-bare_sdl_resume_audio_stream_device(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_stream_t, 1> stream
-) {
-  return SDL_ResumeAudioStreamDevice(stream->handle);
+  // Holding both locks keeps the reader thread and the audio thread out of
+  // the ring while it is reset.
+  uv_mutex_lock(&file->mutex);
+
+  SDL_LockAudioStream(file->stream);
+
+  bool success = SDL_SeekIO(file->io, file->data_start + offset, SDL_IO_SEEK_SET) >= 0;
+
+  if (success) {
+    file->read = offset;
+    file->eof = false;
+    file->ring_read = 0;
+    file->ring_write = 0;
+    file->position = offset;
+    file->ended = false;
+
+    SDL_ClearAudioStream(file->stream);
+  }
+
+  SDL_UnlockAudioStream(file->stream);
+
+  uv_mutex_unlock(&file->mutex);
+
+  uv_sem_post(&file->wake);
+
+  return success;
 }
 
-static uint32_t
-bare_sdl_open_audio_device(
-  js_env_t *env,
+static void
+bare_sdl_set_audio_file_loop(
+  js_env_t *,
   js_receiver_t,
-  uint32_t requested_device_id,
-  std::optional<uint32_t> format,
-  std::optional<int> channels,
-  std::optional<int> freq
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file,
+  bool loop
 ) {
-  int err;
+  uv_mutex_lock(&file->mutex);
 
-  SDL_AudioSpec spec;
-  SDL_AudioSpec *spec_ptr = nullptr;
-  if (format.has_value() && channels.has_value() && freq.has_value()) {
-    spec = {
-      .format = static_cast<SDL_AudioFormat>(format.value()),
-      .channels = channels.value(),
-      .freq = freq.value()
-    };
+  SDL_LockAudioStream(file->stream);
 
-    spec_ptr = &spec;
-  }
+  file->loop = loop;
 
-  auto logical_device_id = SDL_OpenAudioDevice(requested_device_id, spec_ptr);
+  // Let a file that already reached its end wrap around again.
+  if (loop) {
+    file->eof = false;
+    file->ended = false;
+  }
 
-  if (logical_device_id == 0) {
-    err = js_throw_error(env, nullptr, SDL_GetError());
-    assert(err == 0);
+  SDL_UnlockAudioStream(file->stream);
 
-    throw js_pending_exception;
-  }
+  uv_mutex_unlock(&file->mutex);
 
-  return logical_device_id;
+  uv_sem_post(&file->wake);
 }
 
-static void
-bare_sdl_close_audio_device(
+static bool
+bare_sdl_get_audio_file_ended(
   js_env_t *,
   js_receiver_t,
-  uint32_t device_id
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  SDL_CloseAudioDevice(device_id);
+  SDL_LockAudioStream(file->stream);
+
+  bool ended = file->ended && SDL_GetAudioStreamAvailable(file->stream) == 0;
+
+  SDL_UnlockAudioStream(file->stream);
+
+  return ended;
 }
 
 static bool
-bare_sdl_pause_audio_device(
-  js_env_t *env,
+bare_sdl_bind_audio_file(
+  js_env_t *,
   js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file,
   uint32_t device_id
 ) {
-  return SDL_PauseAudioDevice(device_id);
+  return SDL_BindAudioStream(device_id, file->stream);
 }
 
-static bool
-bare_sdl_resume_audio_device(
-  js_env_t *env,
+static void
+bare_sdl_unbind_audio_file(
+  js_env_t *,
   js_receiver_t,
-  uint32_t device_id
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file
 ) {
-  return SDL_ResumeAudioDevice(device_id);
+  SDL_UnbindAudioStream(file->stream);
 }
 
-static std::vector<uint32_t>
-bare_sdl_get_audio_playback_devices(
-  js_env_t *env,
-  js_receiver_t
+static int
+bare_sdl_get_audio_file_data(
+  js_env_t *,
+  js_receiver_t,
+  js_arraybuffer_span_of_t<bare_sdl_audio_file_t, 1> file,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int len
 ) {
-  int count = 0;
-  SDL_AudioDeviceID *devices = SDL_GetAudioPlaybackDevices(&count);
+  int read = 0;
 
-  std::vector<uint32_t> list;
+  // Pulling from JavaScript is not time critical, so fill the ring here rather
+  // than returning short while the reader thread catches up.
+  while (read < len) {
+    uv_mutex_lock(&file->mutex);
 
-  if (devices != nullptr) {
-    for (int i = 0; i < count; i++) {
-      list.push_back(devices[i]);
-    }
-    SDL_free(devices);
-  }
+    bare_sdl__fill_audio_file(file);
 
-  return list;
-}
+    uv_mutex_unlock(&file->mutex);
 
-static std::vector<uint32_t>
-bare_sdl_get_audio_recording_devices(
-  js_env_t *env,
-  js_receiver_t
-) {
-  int count = 0;
-  SDL_AudioDeviceID *devices = SDL_GetAudioRecordingDevices(&count);
+    int n = SDL_GetAudioStreamData(file->stream, &buf[buf_offset + read], len - read);
 
-  std::vector<uint32_t> list;
+    if (n < 0) return read > 0 ? read : n;
 
-  if (devices != nullptr) {
-    for (int i = 0; i < count; i++) {
-      list.push_back(devices[i]);
-    }
-    SDL_free(devices);
+    if (n == 0) break;
+
+    read += n;
   }
 
-  return list;
+  return read;
 }
 
-static std::optional<uint32_t>
-bare_sdl_get_audio_device_list_item(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_device_list_t, 1> list,
-  int index
-) {
-  if (index < 0 || index >= list->count || !list->devices) {
-    return std::nullopt;
+// Audio recorder
+
+// WAV files of floating point samples use the 18 byte format chunk of
+// non-PCM encodings followed by a fact chunk holding the frame count.
+static bool
+bare_sdl__write_wav_header(SDL_IOStream *io, const SDL_AudioSpec &spec, uint64_t data_size) {
+  bool is_float = SDL_AUDIO_ISFLOAT(spec.format);
+
+  Uint32 header = is_float ? 50 : 36;
+  Uint32 size = Uint32(std::min<uint64_t>(data_size, 0xfffffffe - header));
+  Uint16 bits = SDL_AUDIO_BITSIZE(spec.format);
+  Uint16 block_align = Uint16(SDL_AUDIO_FRAMESIZE(spec));
+
+  bool success = SDL_WriteU32LE(io, 0x46464952 /* RIFF */) &&
+                 SDL_WriteU32LE(io, header + size + (size & 1)) &&
+                 SDL_WriteU32LE(io, 0x45564157 /* WAVE */) &&
+                 SDL_WriteU32LE(io, 0x20746d66 /* fmt */) &&
+                 SDL_WriteU32LE(io, is_float ? 18 : 16) &&
+                 SDL_WriteU16LE(io, is_float ? 3 : 1) &&
+                 SDL_WriteU16LE(io, Uint16(spec.channels)) &&
+                 SDL_WriteU32LE(io, Uint32(spec.freq)) &&
+                 SDL_WriteU32LE(io, Uint32(spec.freq) * block_align) &&
+                 SDL_WriteU16LE(io, block_align) &&
+                 SDL_WriteU16LE(io, bits);
+
+  if (success && is_float) {
+    success = SDL_WriteU16LE(io, 0) &&
+              SDL_WriteU32LE(io, 0x74636166 /* fact */) &&
+              SDL_WriteU32LE(io, 4) &&
+              SDL_WriteU32LE(io, size / block_align);
   }
 
-  return list->devices[index];
+  return success &&
+         SDL_WriteU32LE(io, 0x61746164 /* data */) &&
+         SDL_WriteU32LE(io, size);
 }
 
-static std::optional<std::string>
-bare_sdl_get_audio_device_name(
-  js_env_t *env,
-  js_receiver_t,
-  uint32_t device_id
-) {
-  const char *name = SDL_GetAudioDeviceName(device_id);
-  return name ? std::optional<std::string>(name) : std::nullopt;
+static inline std::atomic_ref<uint64_t>
+bare_sdl__audio_recorder_counter(uint64_t &counter) {
+  return std::atomic_ref<uint64_t>(counter);
 }
 
-static double
-bare_sdl_get_audio_device_gain(
-  js_env_t *env,
-  js_receiver_t,
-  uint32_t device_id
-) {
-  return SDL_GetAudioDeviceGain(device_id);
+// Moves converted audio from the stream into the queue. Runs with the stream
+// locked, either on the audio thread or on the JavaScript thread when data is
+// put directly or the recorder is stopped, so there is only ever one producer.
+static void
+bare_sdl__drain_audio_recorder(bare_sdl_audio_recorder_t *recorder) {
+  auto read = bare_sdl__audio_recorder_counter(recorder->read);
+  auto write = bare_sdl__audio_recorder_counter(recorder->write);
+
+  bool queued = false;
+
+  int len;
+
+  while ((len = SDL_GetAudioStreamData(recorder->stream, recorder->chunk, BARE_SDL_AUDIO_RECORDER_CHUNK)) > 0) {
+    uint64_t r = read.load(std::memory_order_acquire);
+    uint64_t w = write.load(std::memory_order_relaxed);
+
+    // Drop whole chunks when the writer falls behind so the file stays frame
+    // aligned.
+    if (uint64_t(len) > recorder->capacity - (w - r)) {
+      bare_sdl__audio_recorder_counter(recorder->dropped).fetch_add(len, std::memory_order_relaxed);
+      continue;
+    }
+
+    uint64_t start = w % recorder->capacity;
+    uint64_t first = std::min<uint64_t>(len, recorder->capacity - start);
+
+    memcpy(&recorder->queue[start], recorder->chunk, first);
+    memcpy(recorder->queue, &recorder->chunk[first], len - first);
+
+    write.store(w + len, std::memory_order_release);
+
+    queued = true;
+  }
+
+  if (queued) uv_sem_post(&recorder->wake);
+}
+
+static void SDLCALL
+bare_sdl__on_audio_recorder_put(void *userdata, SDL_AudioStream *stream, int additional_bytes, int total_bytes) {
+  bare_sdl__drain_audio_recorder(reinterpret_cast<bare_sdl_audio_recorder_t *>(userdata));
 }
 
 static void
-bare_sdl_set_audio_device_gain(
-  js_env_t *env,
-  js_receiver_t,
-  uint32_t device_id,
-  double gain
-) {
-  SDL_SetAudioDeviceGain(device_id, static_cast<float>(gain));
+bare_sdl__on_audio_recorder_thread(void *data) {
+  auto recorder = reinterpret_cast<bare_sdl_audio_recorder_t *>(data);
+
+  auto read = bare_sdl__audio_recorder_counter(recorder->read);
+  auto write = bare_sdl__audio_recorder_counter(recorder->write);
+
+  while (true) {
+    // Check whether the recorder is still running before loading the write
+    // counter, so that audio queued while stopping is always written out.
+    bool running = std::atomic_ref<bool>(recorder->running).load(std::memory_order_acquire);
+
+    uint64_t r = read.load(std::memory_order_relaxed);
+    uint64_t w = write.load(std::memory_order_acquire);
+
+    if (r == w) {
+      if (!running) break;
+
+      uv_sem_wait(&recorder->wake);
+      continue;
+    }
+
+    uint64_t start = r % recorder->capacity;
+    uint64_t len = std::min<uint64_t>(w - r, recorder->capacity - start);
+
+    size_t n = SDL_WriteIO(recorder->io, &recorder->queue[start], len);
+
+    read.store(r + len, std::memory_order_release);
+
+    bare_sdl__audio_recorder_counter(recorder->written).fetch_add(n, std::memory_order_relaxed);
+
+    if (n < len) recorder->failed = true;
+  }
 }
 
-static js_arraybuffer_t
-bare_sdl_get_audio_device_format(
-  js_env_t *env,
-  js_receiver_t,
-  uint32_t device_id
-) {
+static bool
+bare_sdl__stop_audio_recorder(bare_sdl_audio_recorder_t *recorder) {
   int err;
 
-  js_arraybuffer_t handle;
+  if (recorder->stopped) return !recorder->failed;
 
-  bare_sdl_audio_device_format_t *format;
-  err = js_create_arraybuffer(env, format, handle);
+  recorder->stopped = true;
+
+  SDL_UnbindAudioStream(recorder->stream);
+  SDL_FlushAudioStream(recorder->stream);
+
+  SDL_LockAudioStream(recorder->stream);
+
+  bare_sdl__drain_audio_recorder(recorder);
+
+  SDL_UnlockAudioStream(recorder->stream);
+
+  std::atomic_ref<bool>(recorder->running).store(false, std::memory_order_release);
+
+  uv_sem_post(&recorder->wake);
+
+  err = uv_thread_join(&recorder->thread);
   assert(err == 0);
 
-  format->valid = SDL_GetAudioDeviceFormat(
-    device_id,
-    &format->spec,
-    &format->sample_frames
-  );
+  SDL_DestroyAudioStream(recorder->stream);
 
-  return handle;
-}
+  if (recorder->wav) {
+    // RIFF chunks are padded to an even size.
+    if (recorder->written & 1 && !SDL_WriteU8(recorder->io, 0)) recorder->failed = true;
 
-static bool
-bare_sdl_get_audio_device_format_valid(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
-) {
-  return format->valid;
+    if (SDL_SeekIO(recorder->io, 0, SDL_IO_SEEK_SET) < 0 || !bare_sdl__write_wav_header(recorder->io, recorder->spec, recorder->written)) {
+      recorder->failed = true;
+    }
+  }
+
+  if (!SDL_CloseIO(recorder->io)) recorder->failed = true;
+
+  SDL_free(recorder->queue);
+
+  uv_sem_destroy(&recorder->wake);
+
+  return !recorder->failed;
 }
 
-static uint32_t
-bare_sdl_get_audio_device_format_format(
-  js_env_t *env,
-  js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
-) {
-  return format->spec.format;
+// Recorders are allocated outside of the JavaScript heap so that one that is
+// garbage collected while still recording can be stopped, joining its writer
+// thread, before its memory is released.
+static void
+bare_sdl__on_audio_recorder_finalize(js_env_t *env, void *data, void *finalize_hint) {
+  auto recorder = reinterpret_cast<bare_sdl_audio_recorder_t *>(data);
+
+  bare_sdl__stop_audio_recorder(recorder);
+
+  SDL_free(recorder);
 }
 
-static int
-bare_sdl_get_audio_device_format_channels(
+static js_arraybuffer_t
+bare_sdl_create_audio_recorder(
   js_env_t *env,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+  std::string path,
+  uint32_t format,
+  int channels,
+  int freq,
+  uint32_t capacity,
+  bool wav
 ) {
-  return format->spec.channels;
+  int err;
+
+  SDL_AudioSpec spec = {static_cast<SDL_AudioFormat>(format), channels, freq};
+
+  if (wav && (SDL_AUDIO_ISBIGENDIAN(spec.format) || spec.format == SDL_AUDIO_S8)) {
+    err = js_throw_error(env, nullptr, "Unsupported WAV sample format");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  if (capacity < BARE_SDL_AUDIO_RECORDER_CHUNK) {
+    err = js_throw_range_error(env, nullptr, "Recorder queue capacity must be at least 4096 bytes");
+    assert(err == 0);
+
+    throw js_pending_exception;
+  }
+
+  auto recorder = static_cast<bare_sdl_audio_recorder_t *>(SDL_calloc(1, sizeof(bare_sdl_audio_recorder_t)));
+
+  bool success = recorder != nullptr;
+
+  if (success) {
+    recorder->spec = spec;
+    recorder->wav = wav;
+
+    recorder->queue = static_cast<uint8_t *>(SDL_malloc(capacity));
+    recorder->capacity = capacity;
+
+    success = recorder->queue != nullptr;
+  }
+
+  if (success) {
+    recorder->io = SDL_IOFromFile(path.c_str(), "wb");
+
+    success = recorder->io != nullptr;
+  }
+
+  // Reserve room for the header, which is patched with the final data size
+  // once recording stops.
+  if (success && wav) success = bare_sdl__write_wav_header(recorder->io, spec, 0);
+
+  if (success) {
+    recorder->stream = SDL_CreateAudioStream(&spec, &spec);
+
+    success = recorder->stream != nullptr;
+  }
+
+  if (!success) {
+    err = js_throw_error(env, nullptr, SDL_GetError());
+    assert(err == 0);
+
+    if (recorder) {
+      if (recorder->io) SDL_CloseIO(recorder->io);
+
+      SDL_free(recorder->queue);
+      SDL_free(recorder);
+    }
+
+    throw js_pending_exception;
+  }
+
+  recorder->running = true;
+
+  err = uv_sem_init(&recorder->wake, 0);
+  assert(err == 0);
+
+  err = uv_thread_create(&recorder->thread, bare_sdl__on_audio_recorder_thread, recorder);
+  assert(err == 0);
+
+  SDL_SetAudioStreamPutCallback(recorder->stream, bare_sdl__on_audio_recorder_put, recorder);
+
+  js_value_t *handle;
+  err = js_create_external_arraybuffer(env, recorder, sizeof(bare_sdl_audio_recorder_t), bare_sdl__on_audio_recorder_finalize, nullptr, &handle);
+  assert(err == 0);
+
+  return js_arraybuffer_t(handle);
 }
 
-static int
-bare_sdl_get_audio_device_format_freq(
-  js_env_t *env,
+static bool
+bare_sdl_bind_audio_recorder(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+  js_arraybuffer_span_of_t<bare_sdl_audio_recorder_t, 1> recorder,
+  uint32_t device_id
 ) {
-  return format->spec.freq;
+  if (recorder->stopped) return false;
+
+  return SDL_BindAudioStream(device_id, recorder->stream);
 }
 
-static int
-bare_sdl_get_audio_device_format_sample_frames(
-  js_env_t *env,
+static bool
+bare_sdl_put_audio_recorder_data(
+  js_env_t *,
   js_receiver_t,
-  js_arraybuffer_span_of_t<bare_sdl_audio_device_format_t, 1> format
+  js_arraybuffer_span_of_t<bare_sdl_audio_recorder_t, 1> recorder,
+  js_arraybuffer_span_t buf,
+  uint32_t buf_offset,
+  int len
 ) {
-  return format->sample_frames;
+  if (recorder->stopped) return false;
+
+  return SDL_PutAudioStreamData(recorder->stream, &buf[buf_offset], len);
 }
 
 static bool
-bare_sdl_is_audio_device_physical(
-  js_env_t *env,
+bare_sdl_stop_audio_recorder(
+  js_env_t *,
   js_receiver_t,
-  uint32_t deviceId
+  js_arraybuffer_span_of_t<bare_sdl_audio_recorder_t, 1> recorder
 ) {
-  return SDL_IsAudioDevicePhysical(deviceId);
+  return bare_sdl__stop_audio_recorder(recorder);
 }
 
-static bool
-bare_sdl_is_audio_device_playback(
-  js_env_t *env,
+static int64_t
+bare_sdl_get_audio_recorder_bytes_written(
+  js_env_t *,
   js_receiver_t,
-  uint32_t deviceId
+  js_arraybuffer_span_of_t<bare_sdl_audio_recorder_t, 1> recorder
 ) {
-  return SDL_IsAudioDevicePlayback(deviceId);
+  return bare_sdl__audio_recorder_counter(recorder->written).load(std::memory_order_relaxed);
 }
 
-static bool
-bare_sdl_is_audio_device_paused(
-  js_env_t *env,
+static int64_t
+bare_sdl_get_audio_recorder_bytes_dropped(
+  js_env_t *,
   js_receiver_t,
-  uint32_t deviceId
+  js_arraybuffer_span_of_t<bare_sdl_audio_recorder_t, 1> recorder
 ) {
-  return SDL_AudioDevicePaused(deviceId);
+  return bare_sdl__audio_recorder_counter(recorder->dropped).load(std::memory_order_relaxed);
 }
 
 static std::vector<uint32_t>
@@ -1431,6 +5352,20 @@ bare_sdl_exports(js_env_t *env, js_value_t *exports) {
   V(SDL_PIXELFORMAT_XRGB8888)
   V(SDL_PIXELFORMAT_RGBX8888)
 
+  V(SDL_RENDERER_VSYNC_DISABLED)
+
+  V(SDL_COLORSPACE_UNKNOWN)
+  V(SDL_COLORSPACE_SRGB)
+  V(SDL_COLORSPACE_SRGB_LINEAR)
+  V(SDL_COLORSPACE_HDR10)
+  V(SDL_COLORSPACE_JPEG)
+  V(SDL_COLORSPACE_BT601_LIMITED)
+  V(SDL_COLORSPACE_BT601_FULL)
+  V(SDL_COLORSPACE_BT709_LIMITED)
+  V(SDL_COLORSPACE_BT709_FULL)
+  V(SDL_COLORSPACE_BT2020_LIMITED)
+  V(SDL_COLORSPACE_BT2020_FULL)
+
   V(SDL_TEXTUREACCESS_STATIC)
   V(SDL_TEXTUREACCESS_STREAMING)
   V(SDL_TEXTUREACCESS_TARGET)
@@ -1490,11 +5425,67 @@ bare_sdl_exports(js_env_t *env, js_value_t *exports) {
   V(SDL_EVENT_MOUSE_WHEEL)
   V(SDL_EVENT_MOUSE_ADDED)
   V(SDL_EVENT_MOUSE_REMOVED)
+  V(SDL_EVENT_PEN_PROXIMITY_IN)
+  V(SDL_EVENT_PEN_PROXIMITY_OUT)
+  V(SDL_EVENT_PEN_DOWN)
+  V(SDL_EVENT_PEN_UP)
+  V(SDL_EVENT_PEN_BUTTON_DOWN)
+  V(SDL_EVENT_PEN_BUTTON_UP)
+  V(SDL_EVENT_PEN_MOTION)
+  V(SDL_EVENT_PEN_AXIS)
+  V(SDL_EVENT_DROP_FILE)
+  V(SDL_EVENT_DROP_TEXT)
+  V(SDL_EVENT_DROP_BEGIN)
+  V(SDL_EVENT_DROP_COMPLETE)
+  V(SDL_EVENT_DROP_POSITION)
+  V(SDL_EVENT_AUDIO_DEVICE_ADDED)
+  V(SDL_EVENT_AUDIO_DEVICE_REMOVED)
+  V(SDL_EVENT_AUDIO_DEVICE_FORMAT_CHANGED)
   V(SDL_EVENT_CAMERA_DEVICE_ADDED)
   V(SDL_EVENT_CAMERA_DEVICE_REMOVED)
   V(SDL_EVENT_CAMERA_DEVICE_APPROVED)
   V(SDL_EVENT_CAMERA_DEVICE_DENIED)
 
+  V(SDL_EVENT_JOYSTICK_ADDED)
+  V(SDL_EVENT_JOYSTICK_REMOVED)
+  V(SDL_EVENT_GAMEPAD_AXIS_MOTION)
+  V(SDL_EVENT_GAMEPAD_BUTTON_DOWN)
+  V(SDL_EVENT_GAMEPAD_BUTTON_UP)
+  V(SDL_EVENT_GAMEPAD_ADDED)
+  V(SDL_EVENT_GAMEPAD_REMOVED)
+  V(SDL_EVENT_GAMEPAD_REMAPPED)
+
+  V(SDL_GAMEPAD_AXIS_LEFTX)
+  V(SDL_GAMEPAD_AXIS_LEFTY)
+  V(SDL_GAMEPAD_AXIS_RIGHTX)
+  V(SDL_GAMEPAD_AXIS_RIGHTY)
+  V(SDL_GAMEPAD_AXIS_LEFT_TRIGGER)
+  V(SDL_GAMEPAD_AXIS_RIGHT_TRIGGER)
+
+  V(SDL_GAMEPAD_BUTTON_SOUTH)
+  V(SDL_GAMEPAD_BUTTON_EAST)
+  V(SDL_GAMEPAD_BUTTON_WEST)
+  V(SDL_GAMEPAD_BUTTON_NORTH)
+  V(SDL_GAMEPAD_BUTTON_BACK)
+  V(SDL_GAMEPAD_BUTTON_GUIDE)
+  V(SDL_GAMEPAD_BUTTON_START)
+  V(SDL_GAMEPAD_BUTTON_LEFT_STICK)
+  V(SDL_GAMEPAD_BUTTON_RIGHT_STICK)
+  V(SDL_GAMEPAD_BUTTON_LEFT_SHOULDER)
+  V(SDL_GAMEPAD_BUTTON_RIGHT_SHOULDER)
+  V(SDL_GAMEPAD_BUTTON_DPAD_UP)
+  V(SDL_GAMEPAD_BUTTON_DPAD_DOWN)
+  V(SDL_GAMEPAD_BUTTON_DPAD_LEFT)
+  V(SDL_GAMEPAD_BUTTON_DPAD_RIGHT)
+
+  V(SDL_JOYSTICK_AXIS_MAX)
+
+  V(SDL_BUTTON_LEFT)
+  V(SDL_BUTTON_MIDDLE)
+  V(SDL_BUTTON_RIGHT)
+  V(SDL_BUTTON_X1)
+  V(SDL_BUTTON_X2)
+
   V(SDL_SCANCODE_UNKNOWN)
   V(SDL_SCANCODE_A)
   V(SDL_SCANCODE_B)
@@ -1766,6 +5757,12 @@ bare_sdl_exports(js_env_t *env, js_value_t *exports) {
 
 #undef V
 
+  err = js_set_property(env, constants, "SDL_RENDERER_VSYNC_ADAPTIVE", int32_t(SDL_RENDERER_VSYNC_ADAPTIVE));
+  assert(err == 0);
+
+  err = js_set_property(env, constants, "SDL_JOYSTICK_AXIS_MIN", int32_t(SDL_JOYSTICK_AXIS_MIN));
+  assert(err == 0);
+
 #define V(name, function) \
   err = js_set_property<function>(env, exports, name); \
   assert(err == 0);
@@ -1775,13 +5772,35 @@ bare_sdl_exports(js_env_t *env, js_value_t *exports) {
 
   V("createRenderer", bare_sdl_create_renderer)
   V("destroyRenderer", bare_sdl_destroy_renderer)
+  V("getRenderDrivers", bare_sdl_get_render_drivers)
+  V("getRendererName", bare_sdl_get_renderer_name)
+  V("getRendererMaxTextureSize", bare_sdl_get_renderer_max_texture_size)
+  V("getRendererTextureFormats", bare_sdl_get_renderer_texture_formats)
+  V("getRenderVSync", bare_sdl_get_render_vsync)
+  V("setRenderVSync", bare_sdl_set_render_vsync)
   V("clearRender", bare_sdl_clear_render)
   V("presentRender", bare_sdl_present_render)
   V("textureRender", bare_sdl_texture_render)
+  V("renderCommands", bare_sdl_render_commands)
+  V("renderGeometry", bare_sdl_render_geometry)
+  V("setRenderTarget", bare_sdl_set_render_target)
+  V("readRenderPixels", bare_sdl_read_render_pixels)
+  V("enableRenderStats", bare_sdl_enable_render_stats)
+  V("disableRenderStats", bare_sdl_disable_render_stats)
+  V("resetRenderStats", bare_sdl_reset_render_stats)
+  V("getRenderStats", bare_sdl_get_render_stats)
 
   V("createTexture", bare_sdl_create_texture)
   V("destroyTexture", bare_sdl_destroy_texture)
   V("updateTexture", bare_sdl_update_texture)
+  V("updateTextureRects", bare_sdl_update_texture_rects)
+  V("convertTexture", bare_sdl_convert_texture)
+  V("getTextureFormat", bare_sdl_get_texture_format)
+  V("updateYUVTexture", bare_sdl_update_yuv_texture)
+  V("updateNVTexture", bare_sdl_update_nv_texture)
+  V("lockTexture", bare_sdl_lock_texture)
+  V("unlockTexture", bare_sdl_unlock_texture)
+  V("getTexturePitch", bare_sdl_get_texture_pitch)
 
   V("createRect", bare_sdl_create_rect)
   V("setRect", bare_sdl_set_rect)
@@ -1797,14 +5816,38 @@ bare_sdl_exports(js_env_t *env, js_value_t *exports) {
   V("getFRectW", bare_sdl_get_frect_w)
   V("getFRectH", bare_sdl_get_frect_h)
 
+  V("createFrameScheduler", bare_sdl_create_frame_scheduler)
+  V("startFrameScheduler", bare_sdl_start_frame_scheduler)
+  V("stopFrameScheduler", bare_sdl_stop_frame_scheduler)
+  V("destroyFrameScheduler", bare_sdl_destroy_frame_scheduler)
+  V("getFrameSchedulerInterval", bare_sdl_get_frame_scheduler_interval)
+  V("getFrameSchedulerFrames", bare_sdl_get_frame_scheduler_frames)
+  V("getFrameSchedulerSkipped", bare_sdl_get_frame_scheduler_skipped)
+  V("getFrameSchedulerFrameTime", bare_sdl_get_frame_scheduler_frame_time)
+  V("getTicks", bare_sdl_get_ticks)
+
   V("poll", bare_sdl_poll)
-  V("createEvent", bare_sdl_create_event)
-  V("getEventType", bare_sdl_get_event_type)
-  V("getEventKey", bare_sdl_get_event_key)
-  V("getEventKeyScancode", bare_sdl_get_event_key_scancode)
+  V("drain", bare_sdl_drain)
+  V("pumpEvents", bare_sdl_pump_events)
+  V("getKeyboardState", bare_sdl_get_keyboard_state)
+  V("getMouseState", bare_sdl_get_mouse_state)
+
+  V("getGamepadState", bare_sdl_get_gamepad_state)
+  V("attachVirtualJoystick", bare_sdl_attach_virtual_joystick)
+  V("detachVirtualJoystick", bare_sdl_detach_virtual_joystick)
+  V("getVirtualJoystickId", bare_sdl_get_virtual_joystick_id)
+  V("setVirtualJoystickAxis", bare_sdl_set_virtual_joystick_axis)
+  V("setVirtualJoystickButton", bare_sdl_set_virtual_joystick_button)
+  V("setEventEnabled", bare_sdl_set_event_enabled)
+  V("getEventEnabled", bare_sdl_get_event_enabled)
+  V("createEventWatch", bare_sdl_create_event_watch)
+  V("startEventWatch", bare_sdl_start_event_watch)
+  V("stopEventWatch", bare_sdl_stop_event_watch)
+  V("destroyEventWatch", bare_sdl_destroy_event_watch)
 
   V("openAudioDevice", bare_sdl_open_audio_device)
   V("closeAudioDevice", bare_sdl_close_audio_device)
+  V("getAudioDeviceLatency", bare_sdl_get_audio_device_latency)
   V("pauseAudioDevice", bare_sdl_pause_audio_device)
   V("resumeAudioDevice", bare_sdl_resume_audio_device)
   V("getAudioPlaybackDevices", bare_sdl_get_audio_playback_devices)
@@ -1853,10 +5896,53 @@ bare_sdl_exports(js_env_t *env, js_value_t *exports) {
   V("unbindAudioStream", bare_sdl_unbind_audio_stream)
   V("createAudioStream", bare_sdl_create_audio_stream)
   V("destroyAudioStream", bare_sdl_destroy_audio_stream)
+  V("createAudioStreamRing", bare_sdl_create_audio_stream_ring)
+  V("getAudioStreamStats", bare_sdl_get_audio_stream_stats)
+
+  V("createAudioMixer", bare_sdl_create_audio_mixer)
+  V("destroyAudioMixer", bare_sdl_destroy_audio_mixer)
+  V("addAudioMixerSource", bare_sdl_add_audio_mixer_source)
+  V("removeAudioMixerSource", bare_sdl_remove_audio_mixer_source)
+  V("putAudioMixerSourceData", bare_sdl_put_audio_mixer_source_data)
+  V("getAudioMixerSourceAvailable", bare_sdl_get_audio_mixer_source_available)
+  V("setAudioMixerSourceGain", bare_sdl_set_audio_mixer_source_gain)
+  V("setAudioMixerSourcePan", bare_sdl_set_audio_mixer_source_pan)
+  V("bindAudioMixer", bare_sdl_bind_audio_mixer)
+  V("unbindAudioMixer", bare_sdl_unbind_audio_mixer)
+  V("getAudioMixerData", bare_sdl_get_audio_mixer_data)
+  V("openAudioFile", bare_sdl_open_audio_file)
+  V("closeAudioFile", bare_sdl_close_audio_file)
+  V("getAudioFileFormat", bare_sdl_get_audio_file_format)
+  V("getAudioFileChannels", bare_sdl_get_audio_file_channels)
+  V("getAudioFileFreq", bare_sdl_get_audio_file_freq)
+  V("getAudioFileFrames", bare_sdl_get_audio_file_frames)
+  V("getAudioFilePosition", bare_sdl_get_audio_file_position)
+  V("seekAudioFile", bare_sdl_seek_audio_file)
+  V("setAudioFileLoop", bare_sdl_set_audio_file_loop)
+  V("getAudioFileEnded", bare_sdl_get_audio_file_ended)
+  V("bindAudioFile", bare_sdl_bind_audio_file)
+  V("unbindAudioFile", bare_sdl_unbind_audio_file)
+  V("getAudioFileData", bare_sdl_get_audio_file_data)
+  V("createAudioRecorder", bare_sdl_create_audio_recorder)
+  V("bindAudioRecorder", bare_sdl_bind_audio_recorder)
+  V("putAudioRecorderData", bare_sdl_put_audio_recorder_data)
+  V("stopAudioRecorder", bare_sdl_stop_audio_recorder)
+  V("getAudioRecorderBytesWritten", bare_sdl_get_audio_recorder_bytes_written)
+  V("getAudioRecorderBytesDropped", bare_sdl_get_audio_recorder_bytes_dropped)
   V("putAudioStreamData", bare_sdl_put_audio_stream_data)
   V("getAudioStreamData", bare_sdl_get_audio_stream_data)
   V("clearAudioStream", bare_sdl_clear_audio_stream)
   V("flushAudioStream", bare_sdl_flush_audio_stream)
+  V("setAudioStreamFormat", bare_sdl_set_audio_stream_format)
+  V("getAudioStreamFrequencyRatio", bare_sdl_get_audio_stream_frequency_ratio)
+  V("setAudioStreamFrequencyRatio", bare_sdl_set_audio_stream_frequency_ratio)
+  V("getAudioStreamGain", bare_sdl_get_audio_stream_gain)
+  V("setAudioStreamGain", bare_sdl_set_audio_stream_gain)
+  V("getAudioStreamLatency", bare_sdl_get_audio_stream_latency)
+  V("getAudioStreamInputChannelMap", bare_sdl_get_audio_stream_input_channel_map)
+  V("setAudioStreamInputChannelMap", bare_sdl_set_audio_stream_input_channel_map)
+  V("getAudioStreamOutputChannelMap", bare_sdl_get_audio_stream_output_channel_map)
+  V("setAudioStreamOutputChannelMap", bare_sdl_set_audio_stream_output_channel_map)
   V("getAudioStreamAvailable", bare_sdl_get_audio_stream_available)
   V("getAudioStreamDevice", bare_sdl_get_audio_stream_device)
   V("isAudioStreamDevicePaused", bare_sdl_audio_stream_device_paused)
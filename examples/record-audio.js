@@ -1,5 +1,4 @@
 const sdl = require('..')
-const { writeWAVFile } = require('../test/helpers')
 
 const [recordingDeviceName] = Bare.argv.slice(2)
 
@@ -17,27 +16,19 @@ const targetSpec = {
   freq: 44100
 }
 
-const inputStream = new sdl.AudioStream(mic.spec, targetSpec)
+const recorder = new sdl.AudioRecorder('recording.wav', { spec: targetSpec })
 
-mic.bindStream(inputStream)
+recorder.start(mic)
 
-const recordInterval = setInterval(() => {
-  if (inputStream.available > 0) {
-    const buffer = Buffer.allocUnsafe(inputStream.available)
-    const bytesRead = inputStream.get(buffer.buffer)
-    if (bytesRead > 0) {
-      chunks.push(buffer.subarray(0, bytesRead))
-      console.log(`Read ${bytesRead} bytes`)
-    }
-  }
+const progressInterval = setInterval(() => {
+  console.log(`Wrote ${recorder.bytesWritten} bytes`)
 }, 100)
 
-const chunks = []
-
 setTimeout(() => {
-  clearInterval(recordInterval)
+  clearInterval(progressInterval)
+
+  recorder.stop()
   mic.destroy()
 
-  const audioData = Buffer.concat(chunks)
-  writeWAVFile('recording.wav', audioData, targetSpec)
+  console.log(`Saved ${recorder.bytesWritten} bytes, dropped ${recorder.bytesDropped} bytes`)
 }, 5000)
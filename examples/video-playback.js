@@ -3,16 +3,18 @@ const sdl = require('bare-sdl')
 
 class Playback {
   constructor(width, height) {
+    this.height = height
     this.win = new sdl.Window('Window', width, height)
     this.ren = new sdl.Renderer(this.win)
     this.tex = new sdl.Texture(
       this.ren,
       width,
       height,
-      sdl.constants.SDL_PIXELFORMAT_RGB24,
+      sdl.constants.SDL_PIXELFORMAT_IYUV,
       sdl.constants.SDL_TEXTUREACCESS_STREAMING
     )
     this.poller = new sdl.Poller()
+    this.events = new sdl.Event.Batch()
   }
 
   destroy() {
@@ -21,21 +23,25 @@ class Playback {
     this.tex.destroy()
   }
 
-  render(buffer, lineSize) {
-    this.tex.update(buffer, lineSize)
+  render(image) {
+    const height = this.height
+    const yPitch = image.lineSize(0)
+    const uPitch = image.lineSize(1)
+    const vPitch = image.lineSize(2)
+
+    const y = image.data.subarray(0, yPitch * height)
+    const u = image.data.subarray(y.byteLength, y.byteLength + uPitch * Math.ceil(height / 2))
+    const v = image.data.subarray(y.byteLength + u.byteLength)
+
+    this.tex.updateYUV(y, yPitch, u, uPitch, v, vPitch)
     this.ren.clear()
     this.ren.texture(this.tex)
     this.ren.present()
   }
 
   poll() {
-    const event = new sdl.Event()
-
-    if (this.poller.poll(event)) {
-      return event
-    }
-
-    return null
+    this.poller.drain(this.events)
+    return this.events
   }
 }
 
@@ -85,14 +91,11 @@ yuv.height = decoder.height
 yuv.pixelFormat = ffmpeg.constants.pixelFormats.YUV420P
 yuv.alloc()
 
-const rgb = new ffmpeg.Frame()
-rgb.width = decoder.width
-rgb.height = decoder.height
-rgb.pixelFormat = ffmpeg.constants.pixelFormats.RGB24
-rgb.alloc()
-
-const image = new ffmpeg.Image(ffmpeg.constants.pixelFormats.RGB24, rgb.width, rgb.height)
-image.fill(rgb)
+const image = new ffmpeg.Image(
+  ffmpeg.constants.pixelFormats.YUV420P,
+  decoder.width,
+  decoder.height
+)
 
 const toYUV = new ffmpeg.Scaler(
   decoder.pixelFormat,
@@ -103,14 +106,15 @@ const toYUV = new ffmpeg.Scaler(
   yuv.height
 )
 
-const toRGB = new ffmpeg.Scaler(
-  ffmpeg.constants.pixelFormats.YUV420P,
-  decoder.width,
-  decoder.height,
-  ffmpeg.constants.pixelFormats.RGB24,
-  decoder.width,
-  decoder.height
-)
+// The decoder normally returns YUV420P, matching the encoder, but convert
+// anything else before handing it to the IYUV texture.
+const converted = new ffmpeg.Frame()
+converted.width = decoder.width
+converted.height = decoder.height
+converted.pixelFormat = ffmpeg.constants.pixelFormats.YUV420P
+converted.alloc()
+
+let fromDecoded = null
 
 function encode(packet) {
   const result = inputFormatContext.readFrame(packet)
@@ -137,15 +141,31 @@ function decode(buffer) {
 
   const decodedFrame = new ffmpeg.Frame()
   while (decoderContext.receiveFrame(decodedFrame)) {
-    toRGB.scale(decodedFrame, rgb)
-    playback.render(image.data, image.lineSize())
+    let frame = decodedFrame
+
+    if (frame.pixelFormat !== ffmpeg.constants.pixelFormats.YUV420P) {
+      if (fromDecoded === null) {
+        fromDecoded = new ffmpeg.Scaler(
+          frame.pixelFormat,
+          frame.width,
+          frame.height,
+          ffmpeg.constants.pixelFormats.YUV420P,
+          converted.width,
+          converted.height
+        )
+      }
+
+      fromDecoded.scale(frame, converted)
+      frame = converted
+    }
+
+    image.read(frame)
+    playback.render(image)
   }
 }
 
 const loop = setInterval(() => {
-  let event
-
-  while ((event = playback.poll())) {
+  for (const event of playback.poll()) {
     if (event.type === sdl.constants.SDL_EVENT_QUIT) {
       clearInterval(loop)
     }
@@ -1,8 +1,17 @@
 exports.constants = require('./lib/constants')
 exports.AudioDevice = require('./lib/audio-device')
+exports.AudioFile = require('./lib/audio-file')
+exports.AudioMixer = require('./lib/audio-mixer')
+exports.AudioRecorder = require('./lib/audio-recorder')
 exports.Camera = require('./lib/camera')
+exports.CommandBuffer = require('./lib/command-buffer')
 exports.AudioStream = require('./lib/audio-stream')
 exports.Event = require('./lib/event')
+exports.FrameScheduler = require('./lib/frame-scheduler')
+exports.Gamepad = require('./lib/gamepad')
+exports.Keyboard = require('./lib/keyboard')
+exports.Mouse = require('./lib/mouse')
+exports.PixelBufferPool = require('./lib/pixel-buffer-pool')
 exports.Poller = require('./lib/poller')
 exports.Rect = require('./lib/rect')
 exports.Renderer = require('./lib/renderer')
@@ -146,14 +146,22 @@ class SDLAudioDevice {
   constructor(deviceId, spec) {
     this._requestedDeviceId = deviceId
     this.spec = spec
+    this.requestedSampleFrames = spec?.sampleFrames ?? null
 
     const format = this.spec?.format
     const channels = this.spec?.channels
     const freq = this.spec?.freq
+    const sampleFrames = this.spec?.sampleFrames
 
-    this.id = binding.openAudioDevice(this._requestedDeviceId, format, channels, freq)
+    this.id = binding.openAudioDevice(
+      this._requestedDeviceId,
+      format,
+      channels,
+      freq,
+      sampleFrames
+    )
 
-    if (!this.spec) {
+    if (!this.spec || this.spec.format === undefined) {
       this.spec = this.format.spec
     }
   }
@@ -195,6 +203,15 @@ class SDLAudioDevice {
     return binding.getAudioDeviceGain(this.id)
   }
 
+  get sampleFrames() {
+    return this.format.sampleFrames
+  }
+
+  get latency() {
+    if (!this.id) return 0
+    return binding.getAudioDeviceLatency(this.id)
+  }
+
   set gain(volume) {
     binding.setAudioDeviceGain(this.id, volume)
   }
@@ -0,0 +1,104 @@
+const binding = require('../binding')
+
+module.exports = class SDLAudioFile {
+  constructor(path, opts = {}) {
+    const { spec = null, loop = false } = opts
+
+    this.path = path
+    this.device = null
+
+    this._handle = spec
+      ? binding.openAudioFile(path, spec.format, spec.channels, spec.freq)
+      : binding.openAudioFile(path)
+
+    this.spec = {
+      format: binding.getAudioFileFormat(this._handle),
+      channels: binding.getAudioFileChannels(this._handle),
+      freq: binding.getAudioFileFreq(this._handle)
+    }
+
+    this.frames = binding.getAudioFileFrames(this._handle)
+
+    this._loop = false
+
+    if (loop) this.loop = true
+  }
+
+  get duration() {
+    return this.frames / this.spec.freq
+  }
+
+  get position() {
+    if (!this._handle) return 0
+    return binding.getAudioFilePosition(this._handle) / this.spec.freq
+  }
+
+  get loop() {
+    return this._loop
+  }
+
+  set loop(value) {
+    if (!this._handle) return
+    this._loop = !!value
+    binding.setAudioFileLoop(this._handle, this._loop)
+  }
+
+  get ended() {
+    if (!this._handle) return true
+    return binding.getAudioFileEnded(this._handle)
+  }
+
+  seek(seconds) {
+    if (!this._handle) return false
+    return binding.seekAudioFile(this._handle, Math.round(seconds * this.spec.freq))
+  }
+
+  bind(device) {
+    if (!this._handle) throw new Error('Audio file closed')
+
+    if (!device.id) throw new Error('Audio device not open')
+
+    const success = binding.bindAudioFile(this._handle, device.id)
+
+    if (success) {
+      this.device = device
+      device.resume()
+    }
+
+    return success
+  }
+
+  unbind() {
+    if (!this._handle || this.device === null) return
+
+    binding.unbindAudioFile(this._handle)
+
+    this.device = null
+  }
+
+  get(buffer, offset = 0, length) {
+    if (!this._handle) return 0
+
+    const data =
+      buffer instanceof ArrayBuffer
+        ? new Uint8Array(buffer)
+        : new Uint8Array(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+
+    length = length ?? data.byteLength - offset
+
+    return binding.getAudioFileData(this._handle, data.buffer, data.byteOffset + offset, length)
+  }
+
+  destroy() {
+    if (!this._handle) return
+
+    binding.closeAudioFile(this._handle)
+
+    this._handle = null
+    this.device = null
+  }
+
+  [Symbol.dispose]() {
+    this.destroy()
+  }
+}
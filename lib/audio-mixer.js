@@ -0,0 +1,158 @@
+const binding = require('../binding')
+const constants = require('./constants')
+
+class SDLAudioMixerSource {
+  constructor(mixer, spec, opts = {}) {
+    const { gain = 1, pan = 0 } = opts
+
+    this.mixer = mixer
+    this.spec = spec
+    this._gain = gain
+    this._pan = pan
+
+    this.index = binding.addAudioMixerSource(
+      mixer._handle,
+      spec.format,
+      spec.channels,
+      spec.freq,
+      gain,
+      pan
+    )
+  }
+
+  get gain() {
+    return this._gain
+  }
+
+  set gain(value) {
+    if (this.index === -1) return
+    this._gain = value
+    binding.setAudioMixerSourceGain(this.mixer._handle, this.index, value)
+  }
+
+  get pan() {
+    return this._pan
+  }
+
+  set pan(value) {
+    if (this.index === -1) return
+    this._pan = Math.min(Math.max(value, -1), 1)
+    binding.setAudioMixerSourcePan(this.mixer._handle, this.index, this._pan)
+  }
+
+  get available() {
+    if (this.index === -1) return 0
+    return binding.getAudioMixerSourceAvailable(this.mixer._handle, this.index)
+  }
+
+  put(buffer, offset = 0, length) {
+    if (this.index === -1) return false
+
+    const data = toUint8Array(buffer)
+
+    length = length ?? data.byteLength - offset
+
+    return binding.putAudioMixerSourceData(
+      this.mixer._handle,
+      this.index,
+      data.buffer,
+      data.byteOffset + offset,
+      length
+    )
+  }
+
+  destroy() {
+    if (this.index === -1) return
+
+    this.mixer._sources.delete(this)
+
+    if (this.mixer._handle) binding.removeAudioMixerSource(this.mixer._handle, this.index)
+
+    this.index = -1
+  }
+}
+
+function toUint8Array(buffer) {
+  if (buffer instanceof ArrayBuffer) return new Uint8Array(buffer)
+  return new Uint8Array(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+}
+
+module.exports = class SDLAudioMixer {
+  static Source = SDLAudioMixerSource
+
+  static MAX_SOURCES = 32
+
+  constructor(spec = {}) {
+    const { channels = 2, freq = 48000 } = spec
+
+    this.spec = { format: constants.SDL_AUDIO_F32, channels, freq }
+    this.device = null
+
+    this._sources = new Set()
+    this._handle = binding.createAudioMixer(channels, freq)
+  }
+
+  get sources() {
+    return [...this._sources]
+  }
+
+  add(spec, opts = {}) {
+    if (!this._handle) throw new Error('Audio mixer destroyed')
+
+    const source = new SDLAudioMixerSource(this, spec, opts)
+
+    this._sources.add(source)
+
+    return source
+  }
+
+  bind(device) {
+    if (!this._handle) throw new Error('Audio mixer destroyed')
+
+    if (!device.id) throw new Error('Audio device not open')
+
+    const success = binding.bindAudioMixer(this._handle, device.id)
+
+    if (success) {
+      this.device = device
+      device.resume()
+    }
+
+    return success
+  }
+
+  unbind() {
+    if (!this._handle || this.device === null) return
+
+    binding.unbindAudioMixer(this._handle)
+
+    this.device = null
+  }
+
+  get(buffer, offset = 0, length) {
+    if (!this._handle) return 0
+
+    const data = toUint8Array(buffer)
+
+    length = length ?? data.byteLength - offset
+
+    return binding.getAudioMixerData(this._handle, data.buffer, data.byteOffset + offset, length)
+  }
+
+  destroy() {
+    if (!this._handle) return
+
+    for (const source of this._sources) source.index = -1
+
+    this._sources.clear()
+
+    binding.destroyAudioMixer(this._handle)
+
+    this._handle = null
+    this.device = null
+  }
+
+  [Symbol.dispose]() {
+    this.destroy()
+  }
+}
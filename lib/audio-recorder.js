@@ -0,0 +1,90 @@
+const binding = require('../binding')
+const constants = require('./constants')
+
+module.exports = class SDLAudioRecorder {
+  constructor(path, opts = {}) {
+    const {
+      spec = { format: constants.SDL_AUDIO_F32, channels: 1, freq: 48000 },
+      raw = false,
+      capacity = 1024 * 1024
+    } = opts
+
+    this.path = path
+    this.spec = spec
+    this.raw = raw
+    this.device = null
+
+    this._stopped = false
+    this._handle = binding.createAudioRecorder(
+      path,
+      spec.format,
+      spec.channels,
+      spec.freq,
+      capacity,
+      !raw
+    )
+  }
+
+  get recording() {
+    return this.device !== null && !this._stopped
+  }
+
+  get bytesWritten() {
+    if (!this._handle) return 0
+    return binding.getAudioRecorderBytesWritten(this._handle)
+  }
+
+  get bytesDropped() {
+    if (!this._handle) return 0
+    return binding.getAudioRecorderBytesDropped(this._handle)
+  }
+
+  start(device) {
+    if (this._stopped) throw new Error('Audio recorder stopped')
+
+    if (!device.id) throw new Error('Audio device not open')
+
+    const success = binding.bindAudioRecorder(this._handle, device.id)
+
+    if (success) {
+      this.device = device
+      device.resume()
+    }
+
+    return success
+  }
+
+  put(buffer, offset = 0, length) {
+    if (this._stopped) return false
+
+    const data =
+      buffer instanceof ArrayBuffer
+        ? new Uint8Array(buffer)
+        : new Uint8Array(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+
+    length = length ?? data.byteLength - offset
+
+    return binding.putAudioRecorderData(this._handle, data.buffer, data.byteOffset + offset, length)
+  }
+
+  stop() {
+    if (this._stopped) return false
+    this._stopped = true
+
+    this.device = null
+
+    return binding.stopAudioRecorder(this._handle)
+  }
+
+  destroy() {
+    if (!this._handle) return
+
+    this.stop()
+
+    this._handle = null
+  }
+
+  [Symbol.dispose]() {
+    this.destroy()
+  }
+}
@@ -1,11 +1,91 @@
 const binding = require('../binding')
 
+// Keep in sync with the audio ring layout in binding.cc. Offsets are in bytes.
+const RING_READ = 0
+const RING_WRITE = 32
+const RING_HEADER = 64
+
+const READ = RING_READ / 4
+const WRITE = RING_WRITE / 4
+
+class SDLAudioRing {
+  constructor(buffer) {
+    this.capacity = buffer.byteLength - RING_HEADER
+
+    this._positions = new Uint32Array(buffer, 0, RING_HEADER / 4)
+    this._data = new Uint8Array(buffer, RING_HEADER)
+  }
+
+  get available() {
+    return (Atomics.load(this._positions, WRITE) - Atomics.load(this._positions, READ)) >>> 0
+  }
+
+  get free() {
+    return this.capacity - this.available
+  }
+
+  write(buffer) {
+    const data = toUint8Array(buffer)
+
+    const r = Atomics.load(this._positions, READ)
+    const w = Atomics.load(this._positions, WRITE)
+
+    const len = Math.min(data.byteLength, this.capacity - ((w - r) >>> 0))
+    const start = w & (this.capacity - 1)
+    const first = Math.min(len, this.capacity - start)
+
+    this._data.set(data.subarray(0, first), start)
+    this._data.set(data.subarray(first, len), 0)
+
+    Atomics.store(this._positions, WRITE, (w + len) >>> 0)
+
+    return len
+  }
+
+  read(buffer) {
+    const data = toUint8Array(buffer)
+
+    const r = Atomics.load(this._positions, READ)
+    const w = Atomics.load(this._positions, WRITE)
+
+    const len = Math.min(data.byteLength, (w - r) >>> 0)
+    const start = r & (this.capacity - 1)
+    const first = Math.min(len, this.capacity - start)
+
+    data.set(this._data.subarray(start, start + first), 0)
+    data.set(this._data.subarray(0, len - first), first)
+
+    Atomics.store(this._positions, READ, (r + len) >>> 0)
+
+    return len
+  }
+}
+
+// Specs such as SDLAudioSpec expose their fields through prototype getters,
+// which spreading would skip, so read each field explicitly.
+function mergeSpec(current, spec) {
+  return {
+    format: spec.format ?? current.format,
+    channels: spec.channels ?? current.channels,
+    freq: spec.freq ?? current.freq
+  }
+}
+
+function toUint8Array(buffer) {
+  if (buffer instanceof ArrayBuffer) return new Uint8Array(buffer)
+  return new Uint8Array(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+}
+
 module.exports = class SDLAudioStream {
+  static Ring = SDLAudioRing
+
   constructor(source, target, options = {}) {
     this.source = source
     this.target = target
+    this.ring = null
     this._handle = null
     this._destroyed = false
+    this._stats = null
 
     this._handle = binding.createAudioStream(
       source.format,
@@ -69,16 +149,109 @@ module.exports = class SDLAudioStream {
     return binding.getAudioStreamAvailable(this._handle)
   }
 
+  get stats() {
+    if (this._destroyed || !this._handle) return null
+
+    if (this._stats === null) this._stats = new Float64Array(7)
+
+    binding.getAudioStreamStats(this._handle, this._stats.buffer, this._stats.byteOffset)
+
+    return {
+      underruns: this._stats[0],
+      overruns: this._stats[1],
+      coalesced: this._stats[2],
+      deliveries: this._stats[3],
+      delay: {
+        last: this._stats[4],
+        max: this._stats[5],
+        mean: this._stats[6]
+      }
+    }
+  }
+
+  get latency() {
+    if (this._destroyed || !this._handle) return 0
+    return binding.getAudioStreamLatency(this._handle)
+  }
+
   get device() {
     if (this._destroyed || !this._handle) return 0
     return binding.getAudioStreamDevice(this._handle)
   }
 
+  setFormat(source, target) {
+    if (this._destroyed || !this._handle) return
+
+    if (source) source = mergeSpec(this.source, source)
+    if (target) target = mergeSpec(this.target, target)
+
+    binding.setAudioStreamFormat(
+      this._handle,
+      source?.format,
+      source?.channels,
+      source?.freq,
+      target?.format,
+      target?.channels,
+      target?.freq
+    )
+
+    if (source) this.source = source
+    if (target) this.target = target
+  }
+
+  get frequencyRatio() {
+    if (this._destroyed || !this._handle) return 1
+    return binding.getAudioStreamFrequencyRatio(this._handle)
+  }
+
+  set frequencyRatio(ratio) {
+    if (this._destroyed || !this._handle) return
+    binding.setAudioStreamFrequencyRatio(this._handle, ratio)
+  }
+
+  get gain() {
+    if (this._destroyed || !this._handle) return 1
+    return binding.getAudioStreamGain(this._handle)
+  }
+
+  set gain(gain) {
+    if (this._destroyed || !this._handle) return
+    binding.setAudioStreamGain(this._handle, gain)
+  }
+
+  get inputChannelMap() {
+    if (this._destroyed || !this._handle) return null
+    return binding.getAudioStreamInputChannelMap(this._handle)
+  }
+
+  set inputChannelMap(map) {
+    if (this._destroyed || !this._handle) return
+    binding.setAudioStreamInputChannelMap(this._handle, map ? Array.from(map) : null)
+  }
+
+  get outputChannelMap() {
+    if (this._destroyed || !this._handle) return null
+    return binding.getAudioStreamOutputChannelMap(this._handle)
+  }
+
+  set outputChannelMap(map) {
+    if (this._destroyed || !this._handle) return
+    binding.setAudioStreamOutputChannelMap(this._handle, map ? Array.from(map) : null)
+  }
+
   flush() {
     if (this._destroyed || !this._handle) return false
     return binding.flushAudioStream(this._handle)
   }
 
+  createRing(byteLength, opts = {}) {
+    const { recording = false } = opts
+
+    this.ring = new SDLAudioRing(binding.createAudioStreamRing(this._handle, byteLength, recording))
+
+    return this.ring
+  }
+
   clear() {
     if (this._destroyed || !this._handle) return false
     return binding.clearAudioStream(this._handle)
@@ -98,6 +271,8 @@ module.exports = class SDLAudioStream {
       this._handle = null
     }
 
+    this.ring = null
+
     this._get = null
     this._put = null
   }
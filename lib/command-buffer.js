@@ -0,0 +1,128 @@
+const Rect = require('./rect')
+
+// Keep in sync with binding.cc
+const CLEAR = 1
+const PRESENT = 2
+const SET_DRAW_COLOR = 3
+const FILL_RECT = 4
+const RECT = 5
+const LINE = 6
+const CLIP = 7
+const TEXTURE = 8
+
+module.exports = class SDLCommandBuffer {
+  constructor(capacity = 1024) {
+    this._commands = new Float32Array(capacity)
+    this._length = 0
+    this._textures = new Map()
+    this._handles = []
+  }
+
+  get length() {
+    return this._length
+  }
+
+  reset() {
+    this._length = 0
+    this._textures.clear()
+    this._handles.length = 0
+  }
+
+  clear() {
+    this._reserve(1)
+    this._commands[this._length++] = CLEAR
+  }
+
+  present() {
+    this._reserve(1)
+    this._commands[this._length++] = PRESENT
+  }
+
+  setDrawColor(r, g, b, a = 1) {
+    this._push4(SET_DRAW_COLOR, r, g, b, a)
+  }
+
+  fillRect(x, y, w, h) {
+    this._push4(FILL_RECT, x, y, w, h)
+  }
+
+  rect(x, y, w, h) {
+    this._push4(RECT, x, y, w, h)
+  }
+
+  line(x1, y1, x2, y2) {
+    this._push4(LINE, x1, y1, x2, y2)
+  }
+
+  clip(x, y, w, h) {
+    if (w === undefined) this._push4(CLIP, 0, 0, -1, -1)
+    else this._push4(CLIP, x, y, w, h)
+  }
+
+  texture(texture, src, dst) {
+    let index = this._textures.get(texture)
+
+    if (index === undefined) {
+      index = this._handles.length
+      this._textures.set(texture, index)
+      this._handles.push(texture._handle)
+    }
+
+    this._reserve(10)
+
+    const commands = this._commands
+    let i = this._length
+
+    commands[i++] = TEXTURE
+    commands[i++] = index
+
+    writeRect(commands, i, src)
+    writeRect(commands, i + 4, dst)
+
+    this._length = i + 8
+  }
+
+  _push4(op, a, b, c, d) {
+    this._reserve(5)
+
+    const commands = this._commands
+    let i = this._length
+
+    commands[i++] = op
+    commands[i++] = a
+    commands[i++] = b
+    commands[i++] = c
+    commands[i++] = d
+
+    this._length = i
+  }
+
+  _reserve(n) {
+    if (this._length + n <= this._commands.length) return
+
+    const capacity = Math.max(this._commands.length * 2, this._length + n)
+
+    const commands = new Float32Array(capacity)
+    commands.set(this._commands.subarray(0, this._length))
+
+    this._commands = commands
+  }
+}
+
+// Rect handles are copied straight from their backing memory rather than
+// through their getters, which would cost a binding call per component.
+function writeRect(commands, i, rect) {
+  if (!rect) {
+    commands[i] = 0
+    commands[i + 1] = 0
+    commands[i + 2] = -1
+    commands[i + 3] = -1
+  } else if (rect instanceof Rect || rect instanceof Rect.F) {
+    commands.set(rect._view, i)
+  } else {
+    commands[i] = rect.x
+    commands[i + 1] = rect.y
+    commands[i + 2] = rect.w
+    commands[i + 3] = rect.h
+  }
+}
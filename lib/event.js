@@ -1,28 +1,242 @@
-const binding = require('../binding')
+// Keep in sync with the event record layout in binding.cc
+const RECORD_SIZE = 64
+const HEAP_SIZE = 4096
 
 class SDLEvent {
-  constructor() {
-    this._handle = binding.createEvent()
+  constructor(buffer = Buffer.alloc(RECORD_SIZE + HEAP_SIZE)) {
+    this._buffer = buffer
+    this._view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+    this._stride = 1
+    this._index = 0
+    this._key = null
+  }
+
+  // Views into a batch, which stores its records as columns of 32 bit words.
+  static _at(batch, index) {
+    const event = Object.create(this.prototype)
+
+    event._buffer = batch._buffer
+    event._view = batch._view
+    event._stride = batch.capacity
+    event._index = index
+    event._key = null
+
+    return event
+  }
+
+  get _heap() {
+    return this._stride * RECORD_SIZE
+  }
+
+  _offset(byte) {
+    return ((byte >>> 2) * this._stride + this._index) * 4 + (byte & 3)
   }
 
   get type() {
-    return binding.getEventType(this._handle)
+    return this._view.getUint32(this._offset(0), true)
+  }
+
+  get windowID() {
+    return this._view.getUint32(this._offset(4), true)
+  }
+
+  get timestamp() {
+    const lo = this._view.getUint32(this._offset(8), true)
+    const hi = this._view.getUint32(this._offset(12), true)
+
+    return (hi * 2 ** 32 + lo) / 1e6
+  }
+
+  get which() {
+    return this._view.getUint32(this._offset(16), true)
   }
 
   get key() {
-    return new SDLKeyboardEvent(this)
+    if (this._key === null) this._key = new SDLKeyboardEvent(this)
+    return this._key
+  }
+
+  get scancode() {
+    return this._view.getUint32(this._offset(20), true)
+  }
+
+  get keycode() {
+    return this._view.getUint32(this._offset(24), true)
+  }
+
+  get mod() {
+    return this._view.getUint16(this._offset(28), true)
+  }
+
+  get down() {
+    return this._view.getUint8(this._offset(48)) !== 0
+  }
+
+  get repeat() {
+    return this._view.getUint8(this._offset(49)) !== 0
+  }
+
+  get state() {
+    return this._view.getUint32(this._offset(20), true)
+  }
+
+  get button() {
+    return this._view.getUint8(this._offset(20))
+  }
+
+  get clicks() {
+    return this._view.getUint8(this._offset(22))
+  }
+
+  get axis() {
+    return this._view.getUint8(this._offset(20))
+  }
+
+  get value() {
+    return this._view.getInt32(this._offset(24), true)
+  }
+
+  get direction() {
+    return this._view.getUint32(this._offset(20), true)
+  }
+
+  get x() {
+    return this._view.getFloat32(this._offset(24), true)
+  }
+
+  get y() {
+    return this._view.getFloat32(this._offset(28), true)
+  }
+
+  get dx() {
+    return this._view.getFloat32(this._offset(32), true)
+  }
+
+  get dy() {
+    return this._view.getFloat32(this._offset(36), true)
+  }
+
+  get data1() {
+    return this._view.getInt32(this._offset(20), true)
+  }
+
+  get data2() {
+    return this._view.getInt32(this._offset(24), true)
+  }
+
+  get start() {
+    return this._view.getInt32(this._offset(20), true)
+  }
+
+  get length() {
+    return this._view.getInt32(this._offset(24), true)
+  }
+
+  get text() {
+    const offset = this._heap + this._view.getUint32(this._offset(40), true)
+    const length = this._view.getUint32(this._offset(44), true)
+
+    return length === 0 ? '' : this._buffer.toString('utf8', offset, offset + length)
+  }
+
+  get data() {
+    return this.text
+  }
+
+  get recording() {
+    return this._view.getUint8(this._offset(48)) !== 0
+  }
+
+  get truncated() {
+    return this._view.getUint8(this._offset(50)) !== 0
   }
 }
 
 class SDLKeyboardEvent {
   constructor(event = new SDLEvent()) {
-    this._handle = binding.getEventKey(event._handle)
+    this._event = event
   }
 
   get scancode() {
-    return binding.getEventKeyScancode(this._handle)
+    return this._event.scancode
+  }
+
+  get key() {
+    return this._event.keycode
+  }
+
+  get mod() {
+    return this._event.mod
+  }
+
+  get down() {
+    return this._event.down
+  }
+
+  get repeat() {
+    return this._event.repeat
+  }
+}
+
+// Deprecated: earlier versions of Event.Batch handed out Event.Record views
+// where `key` was the virtual key code. Use Event and `keycode` instead.
+class SDLEventRecord extends SDLEvent {
+  get key() {
+    return this.keycode
+  }
+}
+
+class SDLEventBatch {
+  constructor(capacity = 256, textCapacity = 16384) {
+    this.capacity = capacity
+    this.length = 0
+
+    this._buffer = Buffer.alloc(capacity * RECORD_SIZE + textCapacity)
+    this._view = new DataView(this._buffer.buffer, this._buffer.byteOffset, this._buffer.byteLength)
+
+    this.types = this._column(Uint32Array, 0)
+    this.windowIDs = this._column(Uint32Array, 4)
+    this.which = this._column(Uint32Array, 16)
+    this.x = this._column(Float32Array, 24)
+    this.y = this._column(Float32Array, 28)
+    this.dx = this._column(Float32Array, 32)
+    this.dy = this._column(Float32Array, 36)
+
+    this._flags = this._column(Uint32Array, 48)
+  }
+
+  get _heap() {
+    return this.capacity * RECORD_SIZE
+  }
+
+  get truncated() {
+    let count = 0
+
+    for (let i = 0; i < this.length; i++) {
+      if (this._flags[i] & 0xff0000) count++
+    }
+
+    return count
+  }
+
+  at(index) {
+    if (index < 0 || index >= this.length) return null
+
+    return SDLEvent._at(this, index)
+  }
+
+  *[Symbol.iterator]() {
+    for (let i = 0; i < this.length; i++) yield this.at(i)
+  }
+
+  _column(TypedArray, byte) {
+    const offset = this._buffer.byteOffset + (byte / 4) * this.capacity * 4
+
+    return new TypedArray(this._buffer.buffer, offset, this.capacity)
   }
 }
 
 module.exports = SDLEvent
 module.exports.Keyboard = SDLKeyboardEvent
+module.exports.Batch = SDLEventBatch
+module.exports.Record = SDLEventRecord
@@ -0,0 +1,67 @@
+const binding = require('../binding')
+
+module.exports = class SDLFrameScheduler {
+  static now() {
+    return binding.getTicks()
+  }
+
+  constructor(window, onframe, opts = {}) {
+    const { rate } = opts
+
+    this._destroyed = false
+    this._active = false
+
+    this._handle = binding.createFrameScheduler(
+      window ? window._handle : undefined,
+      rate,
+      this._onframe.bind(this, onframe)
+    )
+  }
+
+  get active() {
+    return this._active
+  }
+
+  get interval() {
+    return binding.getFrameSchedulerInterval(this._handle)
+  }
+
+  get frames() {
+    return binding.getFrameSchedulerFrames(this._handle)
+  }
+
+  get skipped() {
+    return binding.getFrameSchedulerSkipped(this._handle)
+  }
+
+  get frameTime() {
+    return binding.getFrameSchedulerFrameTime(this._handle)
+  }
+
+  start() {
+    if (this._destroyed || this._active) return
+    this._active = true
+    binding.startFrameScheduler(this._handle)
+  }
+
+  stop() {
+    if (this._destroyed || !this._active) return
+    this._active = false
+    binding.stopFrameScheduler(this._handle)
+  }
+
+  destroy() {
+    if (this._destroyed) return
+    this._destroyed = true
+    this._active = false
+    binding.destroyFrameScheduler(this._handle)
+  }
+
+  [Symbol.dispose]() {
+    this.destroy()
+  }
+
+  _onframe(onframe, deadline, skipped) {
+    if (!this._destroyed) onframe(deadline, skipped)
+  }
+}
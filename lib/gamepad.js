@@ -0,0 +1,76 @@
+const binding = require('../binding')
+
+// Keep in sync with the gamepad slot layout in binding.cc
+const SLOTS = 8
+const SLOT_SIZE = 8
+const SLOT_AXES = 1
+const SLOT_BUTTONS = 7
+
+let state = null
+
+class SDLVirtualGamepad {
+  constructor(opts = {}) {
+    const { name } = opts
+
+    this._handle = binding.attachVirtualJoystick(name)
+  }
+
+  get id() {
+    return binding.getVirtualJoystickId(this._handle)
+  }
+
+  setAxis(axis, value) {
+    return binding.setVirtualJoystickAxis(this._handle, axis, value)
+  }
+
+  setButton(button, down) {
+    return binding.setVirtualJoystickButton(this._handle, button, down)
+  }
+
+  destroy() {
+    binding.detachVirtualJoystick(this._handle)
+    this._handle = null
+  }
+}
+
+class SDLGamepad {
+  static SLOTS = SLOTS
+  static Virtual = SDLVirtualGamepad
+
+  static get state() {
+    if (state === null) state = new Int32Array(binding.getGamepadState())
+    return state
+  }
+
+  static slot(id) {
+    const state = SDLGamepad.state
+
+    for (let i = 0; i < SLOTS; i++) {
+      if (state[i * SLOT_SIZE] === id) return i
+    }
+
+    return -1
+  }
+
+  static id(slot) {
+    return SDLGamepad.state[slot * SLOT_SIZE]
+  }
+
+  static axis(slot, axis) {
+    return SDLGamepad.state[slot * SLOT_SIZE + SLOT_AXES + axis]
+  }
+
+  static buttons(slot) {
+    return SDLGamepad.state[slot * SLOT_SIZE + SLOT_BUTTONS]
+  }
+
+  static pressed(slot, button) {
+    return (SDLGamepad.buttons(slot) & (1 << button)) !== 0
+  }
+
+  static pump() {
+    binding.pumpEvents()
+  }
+}
+
+module.exports = SDLGamepad
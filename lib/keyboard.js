@@ -0,0 +1,14 @@
+const binding = require('../binding')
+
+let state = null
+
+module.exports = class SDLKeyboard {
+  static get state() {
+    if (state === null) state = new Uint8Array(binding.getKeyboardState())
+    return state
+  }
+
+  static pressed(scancode) {
+    return SDLKeyboard.state[scancode] !== 0
+  }
+}
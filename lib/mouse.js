@@ -0,0 +1,45 @@
+const binding = require('../binding')
+
+let state = null
+
+module.exports = class SDLMouse {
+  static get state() {
+    if (state === null) state = new Float32Array(binding.getMouseState())
+    return state
+  }
+
+  static get x() {
+    return SDLMouse.state[0]
+  }
+
+  static get y() {
+    return SDLMouse.state[1]
+  }
+
+  static get buttons() {
+    return SDLMouse.state[2]
+  }
+
+  // Relative motion is accumulated natively across pumps until read.
+  static get dx() {
+    const state = SDLMouse.state
+    const dx = state[3]
+    state[3] = 0
+    return dx
+  }
+
+  static get dy() {
+    const state = SDLMouse.state
+    const dy = state[4]
+    state[4] = 0
+    return dy
+  }
+
+  static pressed(button) {
+    return (SDLMouse.buttons & (1 << (button - 1))) !== 0
+  }
+
+  static pump() {
+    binding.pumpEvents()
+  }
+}
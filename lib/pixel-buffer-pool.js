@@ -0,0 +1,22 @@
+module.exports = class SDLPixelBufferPool {
+  constructor(byteLength, size = 3) {
+    this.byteLength = byteLength
+    this._free = []
+
+    for (let i = 0; i < size; i++) {
+      this._free.push(Buffer.alloc(byteLength))
+    }
+  }
+
+  get available() {
+    return this._free.length
+  }
+
+  acquire() {
+    return this._free.pop() || Buffer.alloc(this.byteLength)
+  }
+
+  release(buffer) {
+    if (buffer.byteLength === this.byteLength) this._free.push(buffer)
+  }
+}
@@ -1,7 +1,153 @@
 const binding = require('../binding')
+const SDLEvent = require('./event')
+
+// Keep in sync with the latency histogram layout in binding.cc
+const GROUPS = 0x81
+const BUCKETS = 32
+
+class SDLLatencyTracker {
+  constructor() {
+    this._histograms = new Uint32Array(GROUPS * BUCKETS)
+  }
+
+  histogram(type) {
+    const group = Math.min(type >>> 8, GROUPS - 1)
+    return this._histograms.subarray(group * BUCKETS, (group + 1) * BUCKETS)
+  }
+
+  count(type) {
+    let count = 0
+    for (const n of this.histogram(type)) count += n
+    return count
+  }
+
+  percentile(type, p) {
+    const histogram = this.histogram(type)
+    const target = Math.ceil(this.count(type) * p)
+
+    if (target === 0) return 0
+
+    let seen = 0
+
+    for (let i = 0; i < BUCKETS; i++) {
+      seen += histogram[i]
+      if (seen >= target) return 2 ** i / 1000
+    }
+
+    return 2 ** (BUCKETS - 1) / 1000
+  }
+
+  reset() {
+    this._histograms.fill(0)
+  }
+}
+
+class SDLPoller {
+  static LatencyTracker = SDLLatencyTracker
+
+  constructor(opts = {}) {
+    const { coalesce = false, latency = false } = opts
+
+    this.coalesce = coalesce
+    this.latency = latency ? new SDLLatencyTracker() : null
+
+    this._destroyed = false
+    this._watch = null
+    this._batch = null
+    this._onevents = null
+  }
+
+  get watching() {
+    return this._onevents !== null
+  }
 
-module.exports = class SDLPoller {
   poll(event) {
-    return binding.poll(event._handle)
+    const buffer = event._buffer
+
+    const latency = this.latency ? this.latency._histograms : null
+
+    return binding.poll(
+      buffer.buffer,
+      buffer.byteOffset,
+      buffer.byteLength - event._heap,
+      latency ? latency.buffer : undefined,
+      latency ? latency.byteOffset : 0
+    )
+  }
+
+  drain(batch) {
+    return this._drain(batch, true)
+  }
+
+  _drain(batch, pump) {
+    const buffer = batch._buffer
+    const latency = this.latency ? this.latency._histograms : null
+
+    batch.length = binding.drain(
+      buffer.buffer,
+      buffer.byteOffset,
+      batch.capacity,
+      buffer.byteLength - batch._heap,
+      this.coalesce,
+      pump,
+      latency ? latency.buffer : undefined,
+      latency ? latency.byteOffset : 0
+    )
+
+    return batch.length
+  }
+
+  setEventEnabled(type, enabled) {
+    binding.setEventEnabled(type, enabled)
+  }
+
+  isEventEnabled(type) {
+    return binding.getEventEnabled(type)
+  }
+
+  watch(onevents, opts = {}) {
+    if (this._destroyed) return
+
+    const { interval = 8, capacity = 256 } = opts
+
+    if (this._watch === null) this._watch = binding.createEventWatch(this._ondrain.bind(this))
+    else binding.stopEventWatch(this._watch)
+
+    if (this._batch === null || this._batch.capacity !== capacity) {
+      this._batch = new SDLEvent.Batch(capacity)
+    }
+
+    this._onevents = onevents
+
+    binding.startEventWatch(this._watch, interval)
+  }
+
+  unwatch() {
+    if (this._onevents === null) return
+    this._onevents = null
+    binding.stopEventWatch(this._watch)
+  }
+
+  destroy() {
+    if (this._destroyed) return
+    this._destroyed = true
+    this._onevents = null
+    if (this._watch !== null) binding.destroyEventWatch(this._watch)
+  }
+
+  [Symbol.dispose]() {
+    this.destroy()
+  }
+
+  _ondrain() {
+    const batch = this._batch
+
+    while (this._onevents !== null && this._drain(batch, false) > 0) {
+      this._onevents(batch)
+
+      if (batch.length < batch.capacity) break
+    }
   }
 }
+
+module.exports = SDLPoller
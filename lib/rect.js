@@ -3,6 +3,7 @@ const binding = require('../binding')
 class SDLRect {
   constructor(x = 0, y = 0, w = 0, h = 0) {
     this._handle = binding.createRect(x, y, w, h)
+    this._view = new Int32Array(this._handle, 0, 4)
   }
 
   get x() {
@@ -29,6 +30,7 @@ class SDLRect {
 class SDLFRect {
   constructor(x = 0, y = 0, w = 0, h = 0) {
     this._handle = binding.createFRect(x, y, w, h)
+    this._view = new Float32Array(this._handle, 0, 4)
   }
 
   get x() {
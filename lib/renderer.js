@@ -1,8 +1,63 @@
 const binding = require('../binding')
 
-module.exports = class SDLRenderer {
-  constructor(window) {
-    this._handle = binding.createRenderer(window._handle)
+const phases = ['upload', 'clear', 'draw', 'present', 'interval', 'drawCalls', 'uploadedBytes']
+
+class SDLRenderer {
+  static drivers() {
+    return binding.getRenderDrivers()
+  }
+
+  constructor(window, opts = {}) {
+    const { driver, vsync, colorspace } = opts
+
+    this._handle = binding.createRenderer(window._handle, driver, vsync, colorspace)
+    this._target = null
+    this._stats = null
+  }
+
+  get name() {
+    return binding.getRendererName(this._handle)
+  }
+
+  get maxTextureSize() {
+    return binding.getRendererMaxTextureSize(this._handle)
+  }
+
+  get textureFormats() {
+    return binding.getRendererTextureFormats(this._handle)
+  }
+
+  get vsync() {
+    return binding.getRenderVSync(this._handle)
+  }
+
+  set vsync(interval) {
+    binding.setRenderVSync(this._handle, interval)
+  }
+
+  get target() {
+    return this._target
+  }
+
+  get stats() {
+    if (this._stats === null) this._stats = new Float64Array(1 + phases.length * 4)
+
+    binding.getRenderStats(this._handle, this._stats.buffer, this._stats.byteOffset)
+
+    const result = { frames: this._stats[0] }
+
+    for (let i = 0; i < phases.length; i++) {
+      const offset = 1 + i * 4
+
+      result[phases[i]] = {
+        p50: this._stats[offset],
+        p95: this._stats[offset + 1],
+        p99: this._stats[offset + 2],
+        max: this._stats[offset + 3]
+      }
+    }
+
+    return result
   }
 
   destroy() {
@@ -26,4 +81,79 @@ module.exports = class SDLRenderer {
   present() {
     return binding.presentRender(this._handle)
   }
+
+  geometry(texture, vertices) {
+    const {
+      positions,
+      colors,
+      uvs,
+      indices,
+      positionStride = 8,
+      colorStride = 16,
+      uvStride = 8,
+      count = Math.floor(positions.byteLength / positionStride)
+    } = vertices
+
+    return binding.renderGeometry(
+      this._handle,
+      texture ? texture._handle : undefined,
+      count,
+      positions.buffer,
+      positions.byteOffset,
+      positionStride,
+      colors.buffer,
+      colors.byteOffset,
+      colorStride,
+      uvs ? uvs.buffer : undefined,
+      uvs ? uvs.byteOffset : 0,
+      uvStride,
+      indices ? indices.buffer : undefined,
+      indices ? indices.byteOffset : 0,
+      indices ? indices.length : 0,
+      indices ? indices.BYTES_PER_ELEMENT : 0
+    )
+  }
+
+  setTarget(texture) {
+    const success = binding.setRenderTarget(this._handle, texture ? texture._handle : undefined)
+
+    if (success) this._target = texture || null
+
+    return success
+  }
+
+  readPixels(buffer, pitch, rect, pixelFormat) {
+    return binding.readRenderPixels(
+      this._handle,
+      buffer.buffer,
+      buffer.byteOffset,
+      pitch,
+      rect ? rect._handle : undefined,
+      pixelFormat
+    )
+  }
+
+  enableStats() {
+    binding.enableRenderStats(this._handle)
+  }
+
+  disableStats() {
+    binding.disableRenderStats(this._handle)
+  }
+
+  resetStats() {
+    binding.resetRenderStats(this._handle)
+  }
+
+  render(commands) {
+    return binding.renderCommands(
+      this._handle,
+      commands._commands.buffer,
+      commands._commands.byteOffset,
+      commands._length,
+      commands._handles
+    )
+  }
 }
+
+module.exports = SDLRenderer
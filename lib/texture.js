@@ -16,9 +16,20 @@ module.exports = class SDLTexture {
       width,
       height
     )
+    this._renderer = renderer
+    this._pixels = null
+  }
+
+  get format() {
+    return binding.getTextureFormat(this._handle)
+  }
+
+  get pitch() {
+    return binding.getTexturePitch(this._handle)
   }
 
   destroy() {
+    if (this._pixels) this.unlock()
     binding.destroyTexture(this._handle)
     this._handle = null
   }
@@ -26,10 +37,87 @@ module.exports = class SDLTexture {
   update(buffer, pitch, rect) {
     return binding.updateTexture(
       this._handle,
+      this._renderer._handle,
+      buffer.buffer,
+      buffer.byteOffset,
+      pitch,
+      rect ? rect._handle : undefined
+    )
+  }
+
+  updateRects(buffer, pitch, rects, opts = {}) {
+    const { merge = false } = opts
+
+    return binding.updateTextureRects(
+      this._handle,
+      this._renderer._handle,
+      buffer.buffer,
+      buffer.byteOffset,
+      pitch,
+      rects.buffer,
+      rects.byteOffset,
+      rects.length >> 2,
+      merge
+    )
+  }
+
+  convert(buffer, pitch, pixelFormat, rect) {
+    return binding.convertTexture(
+      this._handle,
+      this._renderer._handle,
       buffer.buffer,
       buffer.byteOffset,
       pitch,
+      pixelFormat,
+      rect ? rect._handle : undefined
+    )
+  }
+
+  updateYUV(y, yPitch, u, uPitch, v, vPitch, rect) {
+    return binding.updateYUVTexture(
+      this._handle,
+      this._renderer._handle,
+      y.buffer,
+      y.byteOffset,
+      yPitch,
+      u.buffer,
+      u.byteOffset,
+      uPitch,
+      v.buffer,
+      v.byteOffset,
+      vPitch,
       rect ? rect._handle : undefined
     )
   }
+
+  updateNV(y, yPitch, uv, uvPitch, rect) {
+    return binding.updateNVTexture(
+      this._handle,
+      this._renderer._handle,
+      y.buffer,
+      y.byteOffset,
+      yPitch,
+      uv.buffer,
+      uv.byteOffset,
+      uvPitch,
+      rect ? rect._handle : undefined
+    )
+  }
+
+  lock(rect) {
+    if (this._pixels) {
+      throw new Error('Texture is already locked')
+    }
+
+    this._pixels = binding.lockTexture(this._handle, rect ? rect._handle : undefined)
+
+    return this._pixels
+  }
+
+  unlock() {
+    if (!this._pixels) return
+
+    binding.unlockTexture(this._handle, this._renderer._handle, this._pixels)
+    this._pixels = null
+  }
 }
@@ -1,7 +1,16 @@
 require('./test/audio-device')
+require('./test/audio-file')
+require('./test/audio-mixer')
+require('./test/audio-recorder')
 require('./test/camera')
+require('./test/command-buffer')
 require('./test/audio-stream')
 require('./test/event')
+require('./test/frame-scheduler')
+require('./test/gamepad')
+require('./test/keyboard')
+require('./test/mouse')
+require('./test/pixel-buffer-pool')
 require('./test/poller')
 require('./test/rect')
 require('./test/renderer')
@@ -96,3 +96,26 @@ test('sdl.AudioDeviceFormat', (t) => {
   const spec = format.spec
   t.ok(spec instanceof sdl.AudioDevice.AudioSpec, 'returns AudioSpec instance')
 })
+
+test('sdl.AudioDevice - sample frames and latency', (t) => {
+  if (!hasPlaybackDevice) {
+    t.pass('No default playback device')
+    return
+  }
+
+  const spec = {
+    format: sdl.constants.SDL_AUDIO_F32,
+    channels: 2,
+    freq: 48000,
+    sampleFrames: 256
+  }
+  using device = sdl.AudioDevice.defaultPlaybackDevice(spec)
+
+  t.is(device.requestedSampleFrames, 256, 'reports the requested buffer size')
+  t.ok(device.sampleFrames > 0, 'reports the device buffer size')
+  t.ok(device.latency > 0, 'reports the device buffer latency')
+  t.ok(
+    Math.abs(device.latency - (device.sampleFrames * 1000) / device.format.spec.freq) < 0.001,
+    'latency matches the buffer size'
+  )
+})
@@ -0,0 +1,95 @@
+const test = require('brittle')
+const fs = require('bare-fs')
+const sdl = require('..')
+const { writeWAVFile } = require('./helpers/index')
+
+const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+function ramp(frames) {
+  const data = Buffer.alloc(frames * 2 * 4)
+
+  for (let i = 0; i < frames; i++) {
+    data.writeFloatLE(i / frames, i * 8)
+    data.writeFloatLE(-i / frames, i * 8 + 4)
+  }
+
+  return data
+}
+
+function fixture(t, name, write) {
+  const filename = `${__dirname}/${name}`
+  write(filename)
+  t.teardown(() => fs.unlinkSync(filename))
+  return filename
+}
+
+test('it should open a WAV file', function (t) {
+  const filename = fixture(t, 'audio-file.wav', (f) => writeWAVFile(f, ramp(4800), spec))
+
+  const file = new sdl.AudioFile(filename)
+  t.teardown(() => file.destroy())
+
+  t.is(file.spec.format, sdl.constants.SDL_AUDIO_F32, 'format read from header')
+  t.is(file.spec.channels, 2, 'channels read from header')
+  t.is(file.spec.freq, 48000, 'frequency read from header')
+  t.is(file.frames, 4800, 'frame count read from header')
+  t.ok(Math.abs(file.duration - 0.1) < 0.0001, 'duration derived from frames')
+})
+
+test('AudioFile should play raw PCM', function (t) {
+  const filename = fixture(t, 'audio-file.pcm', (f) => fs.writeFileSync(f, ramp(1024)))
+
+  const file = new sdl.AudioFile(filename, { spec })
+  t.teardown(() => file.destroy())
+
+  t.is(file.frames, 1024, 'frame count derived from file size')
+
+  const output = new Float32Array(1024 * 2)
+  const bytesRead = file.get(output)
+
+  t.is(bytesRead, output.byteLength, 'read the whole file')
+  t.ok(Math.abs(output[2 * 512] - 0.5) < 0.0001, 'samples match')
+  t.ok(file.ended, 'file ended')
+})
+
+test('AudioFile should seek', function (t) {
+  const filename = fixture(t, 'audio-file-seek.wav', (f) => writeWAVFile(f, ramp(4800), spec))
+
+  const file = new sdl.AudioFile(filename)
+  t.teardown(() => file.destroy())
+
+  t.ok(file.seek(0.05), 'seek succeeded')
+  t.ok(Math.abs(file.position - 0.05) < 0.0001, 'position updated')
+
+  const output = new Float32Array(2)
+  file.get(output)
+
+  t.ok(Math.abs(output[0] - 0.5) < 0.0001, 'playback resumes at the seek point')
+})
+
+test('AudioFile should loop', function (t) {
+  const filename = fixture(t, 'audio-file-loop.wav', (f) => writeWAVFile(f, ramp(256), spec))
+
+  const file = new sdl.AudioFile(filename, { loop: true })
+  t.teardown(() => file.destroy())
+
+  const output = new Float32Array(1024 * 2)
+  const bytesRead = file.get(output)
+
+  t.is(bytesRead, output.byteLength, 'read past the end of the file')
+  t.is(output[2 * 256], 0, 'playback wrapped to the start')
+  t.absent(file.ended, 'looping file never ends')
+})
+
+test('AudioFile should reject invalid files', function (t) {
+  const filename = fixture(t, 'audio-file-invalid.wav', (f) => fs.writeFileSync(f, 'not audio'))
+
+  t.exception(() => new sdl.AudioFile(filename), /Not a WAV file/)
+})
+
+test('AudioFile should reject invalid raw specs', function (t) {
+  const filename = fixture(t, 'audio-file-invalid.pcm', (f) => fs.writeFileSync(f, ramp(16)))
+
+  t.exception(() => new sdl.AudioFile(filename, { spec: { ...spec, channels: 0 } }), /Invalid/)
+  t.exception(() => new sdl.AudioFile(filename, { spec: { ...spec, format: 0 } }), /Invalid/)
+})
@@ -0,0 +1,82 @@
+const test = require('brittle')
+const sdl = require('..')
+
+const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+function constant(frames, left, right = left) {
+  const data = new Float32Array(frames * 2)
+
+  for (let i = 0; i < frames; i++) {
+    data[i * 2] = left
+    data[i * 2 + 1] = right
+  }
+
+  return data
+}
+
+test('it should expose an AudioMixer class', function (t) {
+  const mixer = new sdl.AudioMixer()
+  t.teardown(() => mixer.destroy())
+
+  t.ok(mixer._handle, 'mixer has handle')
+  t.is(mixer.spec.format, sdl.constants.SDL_AUDIO_F32, 'mixer outputs F32')
+  t.is(mixer.spec.channels, 2, 'default channel count')
+  t.is(mixer.spec.freq, 48000, 'default frequency')
+})
+
+test('AudioMixer should sum sources with gain', function (t) {
+  const mixer = new sdl.AudioMixer(spec)
+  t.teardown(() => mixer.destroy())
+
+  const a = mixer.add(spec)
+  const b = mixer.add(spec, { gain: 0.5 })
+
+  t.ok(a.put(constant(256, 0.25)), 'put into first source')
+  t.ok(b.put(constant(256, 0.5)), 'put into second source')
+  t.ok(a.available > 0, 'first source has queued data')
+
+  const output = new Float32Array(256 * 2)
+  const bytesRead = mixer.get(output)
+
+  t.is(bytesRead, output.byteLength, 'read a full mix')
+  t.ok(Math.abs(output[0] - 0.5) < 0.0001, 'left channel is mixed')
+  t.ok(Math.abs(output[1] - 0.5) < 0.0001, 'right channel is mixed')
+})
+
+test('AudioMixer should pan stereo sources', function (t) {
+  const mixer = new sdl.AudioMixer(spec)
+  t.teardown(() => mixer.destroy())
+
+  const source = mixer.add(spec)
+  source.pan = -1
+
+  source.put(constant(128, 0.5))
+
+  const output = new Float32Array(128 * 2)
+  mixer.get(output)
+
+  t.ok(Math.abs(output[0] - 0.5 * Math.SQRT2) < 0.0001, 'left channel is boosted')
+  t.ok(Math.abs(output[1]) < 0.0001, 'right channel is silent')
+})
+
+test('AudioMixer should remove sources', function (t) {
+  const mixer = new sdl.AudioMixer(spec)
+  t.teardown(() => mixer.destroy())
+
+  const source = mixer.add(spec)
+  source.put(constant(128, 1))
+  source.destroy()
+
+  t.is(source.index, -1, 'source detached')
+  t.is(mixer.sources.length, 0, 'mixer has no sources')
+  t.absent(source.put(constant(128, 1)), 'put after destroy fails')
+})
+
+test('AudioMixer should limit the number of sources', function (t) {
+  const mixer = new sdl.AudioMixer(spec)
+  t.teardown(() => mixer.destroy())
+
+  for (let i = 0; i < sdl.AudioMixer.MAX_SOURCES; i++) mixer.add(spec)
+
+  t.exception(() => mixer.add(spec), /at most/, 'throws when full')
+})
@@ -0,0 +1,119 @@
+const test = require('brittle')
+const fs = require('bare-fs')
+const sdl = require('..')
+const { hasRecordingDevice } = require('./helpers/index')
+
+const spec = { format: sdl.constants.SDL_AUDIO_S16, channels: 2, freq: 48000 }
+
+function samples(frames) {
+  const data = Buffer.alloc(frames * 4)
+
+  for (let i = 0; i < frames * 2; i++) data.writeInt16LE(i % 32768, i * 2)
+
+  return data
+}
+
+function output(t, name) {
+  const filename = `${__dirname}/${name}`
+  t.teardown(() => fs.unlinkSync(filename))
+  return filename
+}
+
+test('AudioRecorder should write a WAV file', function (t) {
+  const filename = output(t, 'audio-recorder.wav')
+
+  const recorder = new sdl.AudioRecorder(filename, { spec })
+  t.teardown(() => recorder.destroy())
+
+  const data = samples(4800)
+
+  t.ok(recorder.put(data), 'put audio data')
+  t.ok(recorder.stop(), 'stopped without errors')
+
+  t.is(recorder.bytesWritten, data.byteLength, 'all bytes written')
+  t.is(recorder.bytesDropped, 0, 'no bytes dropped')
+
+  const file = fs.readFileSync(filename)
+
+  t.is(file.toString('ascii', 0, 4), 'RIFF', 'RIFF header')
+  t.is(file.toString('ascii', 8, 12), 'WAVE', 'WAVE header')
+  t.is(file.readUInt16LE(20), 1, 'integer PCM')
+  t.is(file.readUInt16LE(22), 2, 'channel count')
+  t.is(file.readUInt32LE(24), 48000, 'sample rate')
+  t.is(file.readUInt16LE(34), 16, 'bits per sample')
+  t.is(file.readUInt32LE(40), data.byteLength, 'data size patched on stop')
+  t.alike(file.subarray(44), data, 'samples match')
+})
+
+test('AudioRecorder should write float WAV files with a fact chunk', function (t) {
+  const filename = output(t, 'audio-recorder-float.wav')
+
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 1, freq: 48000 }
+
+  const recorder = new sdl.AudioRecorder(filename, { spec })
+  t.teardown(() => recorder.destroy())
+
+  const data = Buffer.from(new Float32Array(480).fill(0.5).buffer)
+
+  recorder.put(data)
+  t.ok(recorder.stop(), 'stopped without errors')
+
+  const file = fs.readFileSync(filename)
+
+  t.is(file.readUInt32LE(4), file.byteLength - 8, 'RIFF size')
+  t.is(file.readUInt32LE(16), 18, 'extended format chunk')
+  t.is(file.readUInt16LE(20), 3, 'IEEE float')
+  t.is(file.toString('ascii', 38, 42), 'fact', 'fact chunk')
+  t.is(file.readUInt32LE(46), 480, 'frame count')
+  t.is(file.readUInt32LE(54), data.byteLength, 'data size patched on stop')
+  t.alike(file.subarray(58), data, 'samples match')
+
+  const playback = new sdl.AudioFile(filename)
+  t.teardown(() => playback.destroy())
+
+  t.is(playback.frames, 480, 'file reads back')
+})
+
+test('AudioRecorder should write raw PCM', function (t) {
+  const filename = output(t, 'audio-recorder.pcm')
+
+  const recorder = new sdl.AudioRecorder(filename, { spec, raw: true })
+  t.teardown(() => recorder.destroy())
+
+  const data = samples(1024)
+
+  recorder.put(data)
+  recorder.stop()
+
+  t.alike(fs.readFileSync(filename), data, 'file contains only samples')
+})
+
+test('AudioRecorder should reject a queue smaller than one chunk', function (t) {
+  t.exception(
+    () => new sdl.AudioRecorder(`${__dirname}/audio-recorder-small.wav`, { capacity: 16 }),
+    /capacity/
+  )
+})
+
+test('AudioRecorder should record from a device', function (t) {
+  if (!hasRecordingDevice) {
+    t.pass('No default recording device')
+    return
+  }
+
+  const filename = output(t, 'audio-recorder-device.wav')
+
+  const device = sdl.AudioDevice.defaultRecordingDevice()
+  const recorder = new sdl.AudioRecorder(filename)
+
+  t.teardown(() => {
+    recorder.destroy()
+    device.destroy()
+  })
+
+  t.ok(recorder.start(device), 'recorder bound to device')
+  t.ok(recorder.recording, 'recording')
+
+  t.ok(recorder.stop(), 'stopped without errors')
+  t.absent(recorder.recording, 'not recording')
+})
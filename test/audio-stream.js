@@ -315,3 +315,319 @@ test('AudioStream should support continuous playback', function (t) {
 
   device.bindStream(stream)
 })
+
+test('AudioStream ring should feed playback without callbacks into JS', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  const ring = stream.createRing(4096)
+
+  t.is(ring.capacity, 4096)
+  t.is(ring.free, 4096)
+
+  const input = new Float32Array(256).fill(0.5)
+  t.is(ring.write(input), 1024, 'wrote all samples')
+  t.is(ring.available, 1024)
+
+  const output = new Float32Array(256)
+  const bytesRead = stream.get(output.buffer)
+
+  t.is(bytesRead, 1024, 'stream pulled from the ring')
+  t.is(output[255], 0.5)
+  t.is(ring.available, 0, 'ring was drained')
+})
+
+test('AudioStream ring should receive recorded audio', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  const ring = stream.createRing(4096, { recording: true })
+
+  stream.put(new Float32Array(256).fill(0.25).buffer)
+
+  t.is(ring.available, 1024, 'stream pushed into the ring')
+
+  const output = new Float32Array(256)
+  t.is(ring.read(output), 1024)
+  t.is(output[0], 0.25)
+  t.is(ring.available, 0)
+})
+
+test('AudioStream ring should stay usable after the stream is destroyed', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+
+  const ring = stream.createRing(4096)
+
+  stream.destroy()
+
+  t.is(ring.write(new Float32Array(256)), 1024)
+  t.is(ring.available, 1024)
+})
+
+test('AudioStream ring should count dropped recorded audio as overruns', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  const ring = stream.createRing(1024, { recording: true })
+
+  stream.put(new Float32Array(512).buffer)
+
+  t.is(ring.available, 1024)
+  t.is(stream.available, 0, 'excess audio was dropped')
+  t.is(stream.stats.overruns, 1)
+})
+
+test('AudioStream ring should wrap frames that straddle its end', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_S16, channels: 3, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  const ring = stream.createRing(64)
+
+  const input = new Int16Array(9).map((_, i) => i)
+  const output = new Int16Array(9)
+
+  for (let i = 0; i < 5; i++) {
+    t.is(ring.write(input), 18)
+    t.is(stream.get(output.buffer, 0, 18), 18)
+    t.alike([...output], [...input])
+  }
+
+  t.is(ring.available, 0)
+})
+
+test('AudioStream ring capacity must be a power of two', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  t.exception(() => stream.createRing(1000))
+})
+
+test('AudioStream should expose callback stats', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+
+  const stats = stream.stats
+
+  t.is(stats.underruns, 0)
+  t.is(stats.overruns, 0)
+  t.is(stats.coalesced, 0)
+  t.is(stats.deliveries, 0)
+  t.is(stats.delay.max, 0)
+
+  stream.destroy()
+
+  t.is(stream.stats, null)
+})
+
+test('AudioStream ring should count underruns', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  stream.createRing(4096)
+
+  stream.get(new ArrayBuffer(1024))
+
+  t.is(stream.stats.underruns, 1, 'empty ring was counted')
+})
+
+test('AudioStream should accumulate coalesced get callbacks', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 44100 }
+
+  const stream = new sdl.AudioStream(spec, spec, {
+    get(needed) {
+      t.is(needed, 2048, 'needed bytes were added up')
+      t.is(stream.stats.coalesced, 1)
+      t.is(stream.stats.deliveries, 1)
+      t.is(stream.stats.underruns, 2)
+      stream.destroy()
+    }
+  })
+
+  t.plan(4)
+
+  stream.get(new ArrayBuffer(1024))
+  stream.get(new ArrayBuffer(1024))
+})
+
+test('AudioStream should change format at runtime', function (t) {
+  const stream = new sdl.AudioStream(
+    { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 },
+    { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+  )
+  t.teardown(() => stream.destroy())
+
+  stream.setFormat(null, { format: sdl.constants.SDL_AUDIO_S16 })
+
+  t.is(stream.target.format, sdl.constants.SDL_AUDIO_S16, 'target format updated')
+  t.is(stream.target.channels, 2, 'target channels kept')
+
+  stream.put(new Float32Array(1024 * 2).fill(0.5))
+
+  t.is(stream.available, 1024 * 2 * 2, 'output converted to 16 bit')
+})
+
+test('AudioStream.setFormat reads specs with prototype getters', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  class Spec {
+    get format() {
+      return sdl.constants.SDL_AUDIO_S16
+    }
+
+    get channels() {
+      return 1
+    }
+
+    get freq() {
+      return 44100
+    }
+  }
+
+  stream.setFormat(null, new Spec())
+
+  t.alike(stream.target, { format: sdl.constants.SDL_AUDIO_S16, channels: 1, freq: 44100 })
+})
+
+test('AudioStream should only fix the ring side of the format in ring mode', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const playback = new sdl.AudioStream(spec, spec)
+  t.teardown(() => playback.destroy())
+
+  playback.createRing(4096)
+
+  playback.setFormat(null, { freq: 44100 })
+  t.is(playback.target.freq, 44100, 'playback target changed')
+  t.exception(() => playback.setFormat({ channels: 1 }, null), /input format/)
+
+  const recording = new sdl.AudioStream(spec, spec)
+  t.teardown(() => recording.destroy())
+
+  recording.createRing(4096, { recording: true })
+
+  recording.setFormat({ freq: 44100 }, null)
+  t.is(recording.source.freq, 44100, 'recording source changed')
+  t.exception(() => recording.setFormat(null, { channels: 1 }), /output format/)
+})
+
+test('AudioStream should apply gain', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  t.is(stream.gain, 1, 'unity gain by default')
+
+  stream.gain = 0.5
+
+  t.is(stream.gain, 0.5, 'gain updated')
+
+  stream.put(new Float32Array(256 * 2).fill(0.5))
+
+  const output = new Float32Array(256 * 2)
+  stream.get(output)
+
+  t.ok(Math.abs(output[0] - 0.25) < 0.0001, 'samples scaled by gain')
+})
+
+test('AudioStream should change the frequency ratio', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  t.is(stream.frequencyRatio, 1, 'unity ratio by default')
+
+  stream.frequencyRatio = 2
+
+  t.is(stream.frequencyRatio, 2, 'ratio updated')
+
+  stream.put(new Float32Array(4800 * 2))
+  stream.flush()
+
+  const frames = stream.available / 8
+
+  t.ok(frames > 2000 && frames < 2800, 'playback runs twice as fast')
+
+  t.exception(() => {
+    stream.frequencyRatio = 0
+  }, 'rejects an invalid ratio')
+})
+
+test('AudioStream should remap input channels', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  t.is(stream.inputChannelMap, null, 'no map by default')
+
+  stream.inputChannelMap = [1, 0]
+
+  t.alike(stream.inputChannelMap, [1, 0], 'map updated')
+
+  const input = new Float32Array(256 * 2)
+  for (let i = 0; i < 256; i++) input[i * 2] = 0.5
+
+  stream.put(input)
+
+  const output = new Float32Array(256 * 2)
+  stream.get(output)
+
+  t.is(output[0], 0, 'left channel comes from the right input')
+  t.is(output[1], 0.5, 'right channel comes from the left input')
+
+  stream.inputChannelMap = null
+
+  t.is(stream.inputChannelMap, null, 'map cleared')
+})
+
+test('AudioStream should remap output channels', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  stream.outputChannelMap = [0, 0]
+
+  const input = new Float32Array(256 * 2)
+  for (let i = 0; i < 256; i++) input[i * 2] = 0.5
+
+  stream.put(input)
+
+  const output = new Float32Array(256 * 2)
+  stream.get(output)
+
+  t.is(output[1], 0.5, 'left channel duplicated to the right')
+
+  t.exception(() => {
+    stream.outputChannelMap = [0, 1, 2]
+  }, 'rejects a map with the wrong channel count')
+})
+
+test('AudioStream should report queued latency', function (t) {
+  const spec = { format: sdl.constants.SDL_AUDIO_F32, channels: 2, freq: 48000 }
+
+  const stream = new sdl.AudioStream(spec, spec)
+  t.teardown(() => stream.destroy())
+
+  t.is(stream.latency, 0, 'empty stream has no latency')
+
+  stream.put(new Float32Array(4800 * 2))
+
+  t.ok(Math.abs(stream.latency - 100) < 0.001, 'queued data counts towards latency')
+
+  stream.frequencyRatio = 2
+
+  t.ok(Math.abs(stream.latency - 50) < 0.001, 'latency scales with the frequency ratio')
+})
@@ -0,0 +1,98 @@
+const test = require('brittle')
+const sdl = require('..')
+
+test('it should expose a CommandBuffer class', (t) => {
+  const commands = new sdl.CommandBuffer()
+  t.is(commands.length, 0)
+})
+
+test('CommandBuffer grows and resets', (t) => {
+  const commands = new sdl.CommandBuffer(4)
+
+  for (let i = 0; i < 100; i++) commands.fillRect(i, i, 1, 1)
+  t.is(commands.length, 500)
+
+  commands.reset()
+  t.is(commands.length, 0)
+})
+
+test('CommandBuffer grows from zero capacity', (t) => {
+  const commands = new sdl.CommandBuffer(0)
+
+  commands.fillRect(0, 0, 1, 1)
+  t.is(commands.length, 5)
+})
+
+test('Renderer.render replays a command buffer', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, 100, 100)
+  t.teardown(() => tex.destroy())
+
+  const commands = new sdl.CommandBuffer()
+  commands.setDrawColor(0, 0, 0)
+  commands.clear()
+  commands.clip(0, 0, 50, 50)
+  commands.texture(tex)
+  commands.texture(tex, { x: 0, y: 0, w: 10, h: 10 }, { x: 10, y: 10, w: 20, h: 20 })
+  commands.clip()
+  commands.setDrawColor(1, 0, 0, 1)
+  commands.fillRect(0, 0, 10, 10)
+  commands.rect(10, 10, 10, 10)
+  commands.line(0, 0, 100, 100)
+  commands.present()
+
+  t.is(ren.render(commands), true)
+})
+
+test('CommandBuffer.texture copies Rect and FRect handles', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, 100, 100)
+  t.teardown(() => tex.destroy())
+
+  const commands = new sdl.CommandBuffer()
+  commands.texture(tex, new sdl.Rect(1, 2, 3, 4), new sdl.Rect.F(0.5, 1.5, 2.5, 3.5))
+
+  t.alike(Array.from(commands._commands.subarray(2, 10)), [1, 2, 3, 4, 0.5, 1.5, 2.5, 3.5])
+  t.is(ren.render(commands), true)
+})
+
+test('Renderer.render throws if a recorded texture was destroyed', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, 100, 100)
+
+  const commands = new sdl.CommandBuffer()
+  commands.texture(tex)
+
+  tex.destroy()
+
+  t.exception(() => ren.render(commands), /Recorded texture was destroyed/)
+})
+
+test('Renderer.render rejects malformed command buffers', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const commands = new sdl.CommandBuffer()
+  commands._commands[0] = 255
+  commands._length = 1
+
+  t.exception(() => ren.render(commands))
+})
@@ -30,3 +30,52 @@ test('Event.Keyboard should be initialized by passing an Event instance', (t) =>
   const event = new sdl.Event.Keyboard(new sdl.Event())
   t.ok(event)
 })
+
+test('Event.Batch should start empty', (t) => {
+  const batch = new sdl.Event.Batch(8)
+  t.is(batch.capacity, 8)
+  t.is(batch.length, 0)
+  t.is(batch.at(0), null)
+  t.alike([...batch], [])
+})
+
+test('Event class should read zero for fields of an empty event', (t) => {
+  const event = new sdl.Event()
+  t.is(event.windowID, 0)
+  t.is(event.which, 0)
+  t.is(event.x, 0)
+  t.is(event.data1, 0)
+  t.is(event.text, '')
+  t.is(event.down, false)
+  t.is(event.truncated, false)
+})
+
+test('Event.Batch should return distinct Event views', (t) => {
+  const batch = new sdl.Event.Batch(2)
+  batch.length = 2
+  t.ok(batch.at(0) instanceof sdl.Event)
+  t.not(batch.at(0), batch.at(1))
+})
+
+test('Event.Batch should expose fields as columns', (t) => {
+  const batch = new sdl.Event.Batch(4)
+  batch.length = 2
+  batch.types[1] = 0x400
+  batch.x[1] = 1.5
+  t.is(batch.types.length, 4)
+  t.is(batch.at(0).type, 0)
+  t.is(batch.at(1).type, 0x400)
+  t.is(batch.at(1).x, 1.5)
+  t.is(batch.truncated, 0)
+})
+
+test('Event class should expose a timestamp initialized at zero', (t) => {
+  const event = new sdl.Event()
+  t.is(event.timestamp, 0)
+})
+
+test('Event.Record is a deprecated alias where key is the key code', (t) => {
+  const record = new sdl.Event.Record()
+  t.ok(record instanceof sdl.Event)
+  t.is(record.key, record.keycode)
+})
@@ -0,0 +1,61 @@
+const test = require('brittle')
+const sdl = require('..')
+
+test('FrameScheduler fires frame callbacks with a deadline', (t) => {
+  t.plan(5)
+
+  let frames = 0
+
+  const scheduler = new sdl.FrameScheduler(
+    null,
+    (deadline, skipped) => {
+      if (++frames < 3) return
+
+      t.is(typeof deadline, 'number')
+      t.ok(deadline > sdl.FrameScheduler.now(), 'deadline is ahead of the frame start')
+      t.is(typeof skipped, 'number')
+      t.is(scheduler.frames, 3)
+
+      scheduler.destroy()
+      t.is(scheduler.active, false)
+    },
+    { rate: 120 }
+  )
+
+  t.ok(Math.abs(scheduler.interval - 1000 / 120) < 0.001)
+
+  scheduler.start()
+})
+
+test('FrameScheduler detects skipped frames', (t) => {
+  t.plan(1)
+
+  let frames = 0
+
+  const scheduler = new sdl.FrameScheduler(
+    null,
+    () => {
+      if (++frames === 1) {
+        const end = Date.now() + 50
+        while (Date.now() < end) {}
+        return
+      }
+
+      t.ok(scheduler.skipped > 0)
+      scheduler.destroy()
+    },
+    { rate: 100 }
+  )
+
+  scheduler.start()
+})
+
+test('FrameScheduler uses the display refresh rate by default', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  using scheduler = new sdl.FrameScheduler(win, () => {})
+
+  t.ok(scheduler.interval > 0)
+  t.is(scheduler.frames, 0)
+})
@@ -0,0 +1,49 @@
+const test = require('brittle')
+const sdl = require('..')
+
+test('Gamepad exposes the slot state', (t) => {
+  const state = sdl.Gamepad.state
+
+  t.ok(state instanceof Int32Array)
+  t.is(state.length, sdl.Gamepad.SLOTS * 8)
+  t.is(sdl.Gamepad.state, state, 'state is not copied')
+})
+
+test('Gamepad reflects a virtual gamepad', (t) => {
+  const pad = new sdl.Gamepad.Virtual({ name: 'test' })
+  t.teardown(() => pad.destroy())
+
+  sdl.Gamepad.pump()
+
+  const slot = sdl.Gamepad.slot(pad.id)
+
+  t.ok(slot !== -1, 'gamepad is opened')
+  t.is(sdl.Gamepad.id(slot), pad.id)
+
+  pad.setAxis(sdl.constants.SDL_GAMEPAD_AXIS_LEFTX, sdl.constants.SDL_JOYSTICK_AXIS_MAX)
+  pad.setButton(sdl.constants.SDL_GAMEPAD_BUTTON_SOUTH, true)
+
+  sdl.Gamepad.pump()
+
+  t.is(
+    sdl.Gamepad.axis(slot, sdl.constants.SDL_GAMEPAD_AXIS_LEFTX),
+    sdl.constants.SDL_JOYSTICK_AXIS_MAX
+  )
+  t.ok(sdl.Gamepad.pressed(slot, sdl.constants.SDL_GAMEPAD_BUTTON_SOUTH))
+  t.absent(sdl.Gamepad.pressed(slot, sdl.constants.SDL_GAMEPAD_BUTTON_EAST))
+})
+
+test('Gamepad frees the slot of a detached virtual gamepad', (t) => {
+  const pad = new sdl.Gamepad.Virtual()
+  const id = pad.id
+
+  sdl.Gamepad.pump()
+
+  t.ok(sdl.Gamepad.slot(id) !== -1)
+
+  pad.destroy()
+
+  sdl.Gamepad.pump()
+
+  t.is(sdl.Gamepad.slot(id), -1)
+})
@@ -0,0 +1,14 @@
+const test = require('brittle')
+const sdl = require('..')
+
+test('Keyboard exposes the keyboard state', (t) => {
+  const state = sdl.Keyboard.state
+
+  t.ok(state instanceof Uint8Array)
+  t.ok(state.length > sdl.constants.SDL_SCANCODE_ESCAPE)
+  t.is(sdl.Keyboard.state, state, 'state is not copied')
+})
+
+test('Keyboard reports keys as released', (t) => {
+  t.is(sdl.Keyboard.pressed(sdl.constants.SDL_SCANCODE_ESCAPE), false)
+})
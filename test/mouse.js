@@ -0,0 +1,26 @@
+const test = require('brittle')
+const sdl = require('..')
+
+test('Mouse exposes the mouse state', (t) => {
+  const state = sdl.Mouse.state
+
+  t.ok(state instanceof Float32Array)
+  t.is(state.length, 5)
+  t.is(sdl.Mouse.state, state, 'state is not copied')
+})
+
+test('Mouse state is refreshed on pump', (t) => {
+  sdl.Mouse.pump()
+
+  t.is(typeof sdl.Mouse.x, 'number')
+  t.is(typeof sdl.Mouse.y, 'number')
+  t.is(sdl.Mouse.pressed(sdl.constants.SDL_BUTTON_LEFT), false)
+})
+
+test('Mouse relative motion is reset once read', (t) => {
+  sdl.Mouse.state[3] = 4
+  sdl.Mouse.pump()
+
+  t.ok(sdl.Mouse.dx >= 4, 'pumping accumulates')
+  t.is(sdl.Mouse.dx, 0)
+})
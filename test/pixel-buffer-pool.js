@@ -0,0 +1,24 @@
+const test = require('brittle')
+const sdl = require('..')
+
+test('PixelBufferPool preallocates and recycles buffers', (t) => {
+  const pool = new sdl.PixelBufferPool(64, 2)
+  t.is(pool.available, 2)
+
+  const buffer = pool.acquire()
+  t.is(buffer.byteLength, 64)
+  t.is(pool.available, 1)
+
+  pool.release(buffer)
+  t.is(pool.available, 2)
+})
+
+test('PixelBufferPool allocates when empty and ignores foreign buffers', (t) => {
+  const pool = new sdl.PixelBufferPool(64, 0)
+
+  const buffer = pool.acquire()
+  t.is(buffer.byteLength, 64, 'allocates on demand')
+
+  pool.release(Buffer.alloc(32))
+  t.is(pool.available, 0, 'buffers of another size are not pooled')
+})
@@ -6,3 +6,77 @@ test('Poller class should expose a poll method', (t) => {
   const poller = new sdl.Poller()
   t.ok(typeof poller.poll(event) == 'boolean')
 })
+
+test('Poller class should drain events into a batch', (t) => {
+  const batch = new sdl.Event.Batch(4)
+  const poller = new sdl.Poller()
+
+  const count = poller.drain(batch)
+
+  t.ok(count <= 4)
+  t.is(batch.length, count)
+  t.is(batch.at(count), null)
+})
+
+test('Poller class should watch and unwatch events', (t) => {
+  const poller = new sdl.Poller()
+  t.teardown(() => poller.destroy())
+
+  t.is(poller.watching, false)
+
+  poller.watch(() => {}, { interval: 16 })
+  t.is(poller.watching, true)
+
+  poller.unwatch()
+  t.is(poller.watching, false)
+
+  poller.watch(() => {}, { interval: 0 })
+  t.is(poller.watching, true)
+})
+
+test('Poller class should turn event types on and off', (t) => {
+  const poller = new sdl.Poller()
+  const type = sdl.constants.SDL_EVENT_PEN_AXIS
+
+  t.teardown(() => poller.setEventEnabled(type, true))
+
+  poller.setEventEnabled(type, false)
+  t.is(poller.isEventEnabled(type), false)
+
+  poller.setEventEnabled(type, true)
+  t.is(poller.isEventEnabled(type), true)
+})
+
+test('Poller class should drain with motion coalescing', (t) => {
+  const batch = new sdl.Event.Batch(4)
+  const poller = new sdl.Poller({ coalesce: true })
+
+  t.is(poller.coalesce, true)
+  t.ok(poller.drain(batch) <= 4)
+})
+
+test('Poller class should track event latency', (t) => {
+  const poller = new sdl.Poller({ latency: true })
+  const tracker = poller.latency
+
+  t.ok(tracker instanceof sdl.Poller.LatencyTracker)
+
+  poller.drain(new sdl.Event.Batch())
+  poller.poll(new sdl.Event())
+
+  const type = sdl.constants.SDL_EVENT_KEY_DOWN
+
+  t.is(tracker.histogram(type).length, 32)
+  t.is(tracker.count(type), 0)
+  t.is(tracker.percentile(type, 0.99), 0)
+
+  tracker.histogram(type)[4] = 1
+
+  t.is(tracker.count(type), 1)
+  t.is(tracker.percentile(type, 0.5), 0.016)
+  t.is(tracker.count(sdl.constants.SDL_EVENT_KEY_UP), 1, 'key events share a category')
+
+  tracker.reset()
+
+  t.is(tracker.count(type), 0)
+})
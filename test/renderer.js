@@ -58,3 +58,225 @@ test('Renderer.texture accepts src and dst FRects', (t) => {
   const dst = new sdl.Rect.F(25, 25, 50, 50)
   t.ok(typeof ren.texture(tex, src, dst) == 'boolean')
 })
+
+test('Renderer.geometry renders separate vertex arrays', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const positions = new Float32Array([0, 0, 100, 0, 100, 100, 0, 100])
+  const colors = new Float32Array(16).fill(1)
+  const indices = new Uint16Array([0, 1, 2, 2, 3, 0])
+
+  t.is(ren.geometry(null, { positions, colors, indices }), true)
+})
+
+test('Renderer.geometry renders interleaved vertices with a texture', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, 100, 100)
+  t.teardown(() => tex.destroy())
+
+  // x, y, r, g, b, a, u, v
+  const vertices = new Float32Array([
+    0, 0, 1, 1, 1, 1, 0, 0, 100, 0, 1, 1, 1, 1, 1, 0, 100, 100, 1, 1, 1, 1, 1, 1
+  ])
+
+  const stride = 8 * 4
+
+  t.is(
+    ren.geometry(tex, {
+      positions: vertices,
+      colors: vertices.subarray(2),
+      uvs: vertices.subarray(6),
+      positionStride: stride,
+      colorStride: stride,
+      uvStride: stride,
+      count: 3
+    }),
+    true
+  )
+})
+
+test('Renderer.geometry throws when a buffer is too small', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const positions = new Float32Array(6)
+  const colors = new Float32Array(4)
+
+  t.exception(() => ren.geometry(null, { positions, colors }))
+})
+
+test('Renderer.setTarget renders into a texture', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    16,
+    16,
+    sdl.constants.SDL_PIXELFORMAT_ARGB8888,
+    sdl.constants.SDL_TEXTUREACCESS_TARGET
+  )
+  t.teardown(() => tex.destroy())
+
+  t.is(ren.setTarget(tex), true)
+  t.is(ren.target, tex)
+
+  t.is(ren.setTarget(null), true)
+  t.is(ren.target, null)
+})
+
+test('Renderer.readPixels reads into a pooled buffer', (t) => {
+  const width = 16
+  const height = 16
+  const pitch = width * 4
+
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    width,
+    height,
+    sdl.constants.SDL_PIXELFORMAT_ARGB8888,
+    sdl.constants.SDL_TEXTUREACCESS_TARGET
+  )
+  t.teardown(() => tex.destroy())
+
+  const commands = new sdl.CommandBuffer()
+  commands.setDrawColor(1, 0, 0, 1)
+  commands.clear()
+
+  ren.setTarget(tex)
+  ren.render(commands)
+
+  const pool = new sdl.PixelBufferPool(pitch * height, 2)
+
+  const buffer = pool.acquire()
+  t.is(pool.available, 1)
+
+  t.is(ren.readPixels(buffer, pitch, null, sdl.constants.SDL_PIXELFORMAT_ARGB8888), true)
+  t.is(buffer.readUInt32LE(0), 0xffff0000)
+
+  pool.release(buffer)
+  t.is(pool.available, 2)
+})
+
+test('Renderer.readPixels throws when the buffer is too small', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  t.exception(() => ren.readPixels(Buffer.alloc(16), 400))
+})
+
+test('Renderer.readPixels throws when the pitch is shorter than a row', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const rect = new sdl.Rect(0, 0, 10, 10)
+
+  t.exception(
+    () => ren.readPixels(Buffer.alloc(4096), 4, rect, sdl.constants.SDL_PIXELFORMAT_ARGB8888),
+    /Pitch too small/
+  )
+})
+
+test('Renderer.drivers lists the available render drivers', (t) => {
+  const drivers = sdl.Renderer.drivers()
+  t.ok(Array.isArray(drivers))
+  t.ok(drivers.includes('software'))
+})
+
+test('Renderer can be created with a specific driver', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win, {
+    driver: 'software',
+    vsync: sdl.constants.SDL_RENDERER_VSYNC_DISABLED
+  })
+  t.teardown(() => ren.destroy())
+
+  t.is(ren.name, 'software')
+  t.is(ren.vsync, sdl.constants.SDL_RENDERER_VSYNC_DISABLED)
+})
+
+test('Renderer exposes its capabilities', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  t.is(typeof ren.name, 'string')
+  t.ok(ren.maxTextureSize > 0)
+  t.ok(ren.textureFormats.length > 0)
+})
+
+test('Renderer throws for an unknown driver', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  t.exception(() => new sdl.Renderer(win, { driver: 'unknown' }))
+})
+
+test('Renderer records per-frame stats', (t) => {
+  const win = new sdl.Window('test', 100, 100)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, 10, 10, sdl.constants.SDL_PIXELFORMAT_RGBA32)
+  t.teardown(() => tex.destroy())
+
+  t.is(ren.stats.frames, 0)
+
+  ren.enableStats()
+
+  for (let i = 0; i < 3; i++) {
+    tex.update(Buffer.alloc(10 * 10 * 4), 10 * 4)
+    ren.clear()
+    ren.texture(tex)
+    ren.present()
+  }
+
+  const stats = ren.stats
+
+  t.is(stats.frames, 3)
+  t.is(stats.drawCalls.max, 1)
+  t.is(stats.uploadedBytes.p50, 10 * 10 * 4)
+  t.ok(stats.present.max >= stats.present.p50)
+
+  ren.resetStats()
+
+  t.is(ren.stats.frames, 0)
+
+  ren.disableStats()
+  ren.present()
+
+  t.is(ren.stats.frames, 0)
+})
@@ -93,3 +93,284 @@ test('Texture.update accepts a sub-region Rect', (t) => {
   const rect = new sdl.Rect(0, 0, 10, height)
   t.ok(typeof tex.update(buf, pitch, rect) == 'boolean')
 })
+
+test('Texture.lock exposes the texture memory until unlock', (t) => {
+  const width = 16
+  const height = 4
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    width,
+    height,
+    sdl.constants.SDL_PIXELFORMAT_ARGB8888,
+    sdl.constants.SDL_TEXTUREACCESS_STREAMING
+  )
+  t.teardown(() => tex.destroy())
+
+  const pixels = tex.lock()
+  t.ok(pixels instanceof ArrayBuffer)
+  t.ok(tex.pitch >= width * 4)
+  t.is(pixels.byteLength, tex.pitch * height)
+
+  new Uint8Array(pixels).fill(0xff)
+
+  tex.unlock()
+  t.is(pixels.byteLength, 0, 'buffer is detached on unlock')
+  t.is(tex.pitch, 0)
+})
+
+test('Texture.lock throws for static textures', (t) => {
+  const win = new sdl.Window('test', 10, 10)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    10,
+    10,
+    sdl.constants.SDL_PIXELFORMAT_ARGB8888,
+    sdl.constants.SDL_TEXTUREACCESS_STATIC
+  )
+  t.teardown(() => tex.destroy())
+
+  t.exception(() => tex.lock())
+})
+
+test('Texture.lock rejects sub-regions of planar textures', (t) => {
+  const win = new sdl.Window('test', 16, 8)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    16,
+    8,
+    sdl.constants.SDL_PIXELFORMAT_IYUV,
+    sdl.constants.SDL_TEXTUREACCESS_STREAMING
+  )
+  t.teardown(() => tex.destroy())
+
+  t.exception(() => tex.lock(new sdl.Rect(0, 0, 8, 4)), /Planar textures/)
+
+  const pixels = tex.lock()
+  t.is(pixels.byteLength, tex.pitch * 8 + 2 * (tex.pitch / 2) * 4, 'covers every plane')
+  tex.unlock()
+})
+
+test('Texture.lock bounds sub-region buffers to the locked rect', (t) => {
+  const width = 16
+  const height = 8
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    width,
+    height,
+    sdl.constants.SDL_PIXELFORMAT_ARGB8888,
+    sdl.constants.SDL_TEXTUREACCESS_STREAMING
+  )
+  t.teardown(() => tex.destroy())
+
+  t.exception(() => tex.lock(new sdl.Rect(8, 4, 16, 4)), /Rect out of bounds/)
+  t.exception(() => tex.lock(new sdl.Rect(-1, 0, 4, 4)), /Rect out of bounds/)
+
+  const pixels = tex.lock(new sdl.Rect(8, 4, 8, 4))
+  t.is(pixels.byteLength, tex.pitch * 3 + 8 * 4, 'ends at the last pixel of the rect')
+  tex.unlock()
+})
+
+test('Texture.updateYUV uploads separate planes', (t) => {
+  const width = 16
+  const height = 8
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    width,
+    height,
+    sdl.constants.SDL_PIXELFORMAT_IYUV,
+    sdl.constants.SDL_TEXTUREACCESS_STREAMING
+  )
+  t.teardown(() => tex.destroy())
+
+  const y = Buffer.alloc(width * height)
+  const u = Buffer.alloc((width / 2) * (height / 2))
+  const v = Buffer.alloc((width / 2) * (height / 2))
+
+  t.ok(tex.updateYUV(y, width, u, width / 2, v, width / 2))
+  t.exception(
+    () => tex.updateYUV(y, width, u.subarray(1), width / 2, v, width / 2),
+    /Plane buffer too small/
+  )
+  t.exception(
+    () => tex.updateYUV(y, width / 2, u, width / 2, v, width / 2),
+    /Plane pitch too small/
+  )
+})
+
+test('Texture.updateNV uploads separate planes', (t) => {
+  const width = 16
+  const height = 8
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(
+    ren,
+    width,
+    height,
+    sdl.constants.SDL_PIXELFORMAT_NV12,
+    sdl.constants.SDL_TEXTUREACCESS_STREAMING
+  )
+  t.teardown(() => tex.destroy())
+
+  const y = Buffer.alloc(width * height)
+  const uv = Buffer.alloc(width * (height / 2))
+
+  t.ok(tex.updateNV(y, width, uv, width))
+  t.exception(() => tex.updateNV(y, width, uv.subarray(1), width), /Plane buffer too small/)
+  t.exception(() => tex.updateNV(y, width, uv, width / 2), /Plane pitch too small/)
+})
+
+test('Texture selects the renderer preferred format for SDL_PIXELFORMAT_UNKNOWN', (t) => {
+  const win = new sdl.Window('test', 10, 10)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, 10, 10, sdl.constants.SDL_PIXELFORMAT_UNKNOWN)
+  t.teardown(() => tex.destroy())
+
+  t.not(tex.format, sdl.constants.SDL_PIXELFORMAT_UNKNOWN)
+  t.ok(ren.textureFormats.includes(tex.format))
+})
+
+test('Texture.convert uploads pixels in a different format', (t) => {
+  const width = 10
+  const height = 10
+  const pitch = width * 3 // RGB24
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, width, height, sdl.constants.SDL_PIXELFORMAT_UNKNOWN)
+  t.teardown(() => tex.destroy())
+
+  const buf = Buffer.alloc(pitch * height)
+
+  t.is(tex.convert(buf, pitch, sdl.constants.SDL_PIXELFORMAT_RGB24), true)
+  t.exception(() => tex.convert(buf.subarray(1), pitch, sdl.constants.SDL_PIXELFORMAT_RGB24))
+})
+
+test('Texture.convert rejects short pitches and rects outside the texture', (t) => {
+  const width = 10
+  const height = 10
+  const pitch = width * 3 // RGB24
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, width, height, sdl.constants.SDL_PIXELFORMAT_ARGB8888)
+  t.teardown(() => tex.destroy())
+
+  const buf = Buffer.alloc(pitch * height * 4)
+
+  t.exception(() => tex.convert(buf, 0, sdl.constants.SDL_PIXELFORMAT_RGB24), /Pitch too small/)
+  const rect = new sdl.Rect(5, 5, 20, 20)
+
+  t.exception(
+    () => tex.convert(buf, pitch * 2, sdl.constants.SDL_PIXELFORMAT_RGB24, rect),
+    /Rect out of bounds/
+  )
+})
+
+test('Texture.updateRects uploads several regions in one call', (t) => {
+  const width = 32
+  const height = 32
+  const pitch = width * 4
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, width, height, sdl.constants.SDL_PIXELFORMAT_ARGB8888)
+  t.teardown(() => tex.destroy())
+
+  const buf = Buffer.alloc(pitch * height)
+  const rects = new Int32Array([0, 0, 8, 8, 4, 4, 8, 8, 20, 20, 100, 100])
+
+  t.is(tex.updateRects(buf, pitch, rects), true)
+  t.is(tex.updateRects(buf, pitch, rects, { merge: true }), true)
+})
+
+test('Texture.updateRects throws when a rect is outside the buffer', (t) => {
+  const width = 32
+  const height = 32
+  const pitch = width * 4
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, width, height, sdl.constants.SDL_PIXELFORMAT_ARGB8888)
+  t.teardown(() => tex.destroy())
+
+  const buf = Buffer.alloc(pitch * 4)
+  const rects = new Int32Array([0, 0, 8, 8])
+
+  t.exception(() => tex.updateRects(buf, pitch, rects))
+})
+
+test('Texture.updateRects throws when the pitch is narrower than a rect', (t) => {
+  const width = 32
+  const height = 32
+
+  const win = new sdl.Window('test', width, height)
+  t.teardown(() => win.destroy())
+
+  const ren = new sdl.Renderer(win)
+  t.teardown(() => ren.destroy())
+
+  const tex = new sdl.Texture(ren, width, height, sdl.constants.SDL_PIXELFORMAT_ARGB8888)
+  t.teardown(() => tex.destroy())
+
+  const buf = Buffer.alloc(width * 4 * height)
+  const rects = new Int32Array([0, 0, 8, 8])
+
+  t.exception(() => tex.updateRects(buf, 0, rects), /Pitch too small/)
+  t.exception(() => tex.updateRects(buf, 8 * 4 - 1, rects), /Pitch too small/)
+})